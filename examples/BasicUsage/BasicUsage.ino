@@ -10,6 +10,7 @@
  *
  * Setup:
  * 1. Install ArduinoJson library (Tools -> Manage Libraries -> Search "ArduinoJson")
+ *    (used internally for command parsing)
  * 2. For Arduino UNO R4 WiFi: Install ArduinoHttpClient library
  * 3. Update WiFi credentials below
  * 4. Update PROJECT_ID and API_KEY from https://inventronix.club/iot-relay/projects
@@ -18,7 +19,6 @@
  */
 
 #include <Inventronix.h>
-#include <ArduinoJson.h>
 
 // WiFi credentials
 #define WIFI_SSID "your-wifi-ssid"
@@ -60,24 +60,21 @@ void loop() {
     // Required for pulse timing on Arduino UNO R4 (no-op on ESP platforms)
     inventronix.loop();
 
-    // Create JSON payload
-    JsonDocument doc;
+    // Build the payload straight into the library's transmit buffer
+    // (no JsonDocument or String needed)
+    Inventronix::Payload& payload = inventronix.beginPayload();
 
     // Example: Temperature sensor data
-    doc["temperature"] = 23.5;
-    doc["humidity"] = 65.2;
-
-    // Serialize to string
-    String jsonPayload;
-    serializeJson(doc, jsonPayload);
+    payload.add("temperature", 23.5);
+    payload.add("humidity", 65.2);
 
     Serial.println("Sending data...");
     Serial.print("Payload: ");
-    Serial.println(jsonPayload);
+    Serial.println(payload.c_str());
     Serial.println();
 
     // Send to Inventronix
-    bool success = inventronix.sendPayload(jsonPayload.c_str());
+    bool success = inventronix.sendPayload(payload);
 
     if (success) {
         Serial.println("Successfully sent data!\n");
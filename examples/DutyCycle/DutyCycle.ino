@@ -0,0 +1,66 @@
+/**
+ * Inventronix Deep-Sleep Duty Cycle
+ *
+ * A battery soil-moisture node. It wakes every 5 minutes, reads the sensor,
+ * and goes straight back to deep sleep. Every third wake it also switches
+ * WiFi on and sends all three readings in one request. Any commands in the
+ * response (here, watering the pot) run before it sleeps again.
+ *
+ * Readings, their sequence numbers, unsent acks and the server clock are
+ * kept in RTC memory across deep sleep, so a failed upload is retried on the
+ * next upload cycle and nothing is lost.
+ *
+ * Supported Hardware:
+ * - ESP32 (all variants) - deep sleep between cycles
+ * - Arduino UNO R4 WiFi  - WiFi off and delay() between cycles
+ *
+ * Setup:
+ * 1. Update WiFi credentials and Inventronix credentials below
+ * 2. Connect a capacitive soil sensor to SOIL_PIN and a pump relay to PUMP_PIN
+ * 3. In your project, add a rule that sends a "water" command when soil is dry
+ * 4. Open Serial Monitor (115200 baud) to see each cycle's awake and radio time
+ */
+
+#include <Inventronix.h>
+
+// WiFi credentials
+#define WIFI_SSID "your-wifi-ssid"
+#define WIFI_PASSWORD "your-wifi-password"
+
+// Inventronix credentials (get these from https://inventronix.club/iot-relay/projects)
+#define PROJECT_ID "proj_abc123"
+#define API_KEY "key_xyz789"
+
+#define SOIL_PIN 34
+#define PUMP_PIN 5
+
+#define SAMPLE_PERIOD_MS (5 * 60 * 1000UL)
+#define SAMPLES_PER_UPLOAD 3
+
+Inventronix inventronix;
+
+void setup() {
+    Serial.begin(115200);
+
+    inventronix.begin(PROJECT_ID, API_KEY);
+
+    // Runs before the node sleeps again (the cycle waits for it to finish)
+    inventronix.onPulse("water", PUMP_PIN, 3000);
+
+    DutyCycleStats stats = inventronix.dutyCycleStats();
+    Serial.print("Woke for cycle ");
+    Serial.print(stats.cycle + 1);
+    Serial.print(", ");
+    Serial.print(stats.pendingSamples);
+    Serial.println(" sample(s) waiting to upload");
+
+    // Never returns
+    inventronix.runDutyCycle(WIFI_SSID, WIFI_PASSWORD, SAMPLE_PERIOD_MS,
+        [](Inventronix::Payload& payload) {
+            payload.add("soil", analogRead(SOIL_PIN));
+        }, SAMPLES_PER_UPLOAD);
+}
+
+void loop() {
+    // Not reached: runDutyCycle() sleeps and wakes the board itself
+}
@@ -85,19 +85,16 @@ void loop() {
     }
 
     // Build payload - report ACTUAL hardware state
-    JsonDocument doc;
-    doc["temperature"] = temperature;
-    doc["humidity"] = humidity;
-    doc["heater_on"] = (digitalRead(HEATER_PIN) == HIGH);
-
-    String jsonPayload;
-    serializeJson(doc, jsonPayload);
+    Inventronix::Payload& payload = inventronix.beginPayload();
+    payload.add("temperature", temperature);
+    payload.add("humidity", humidity);
+    payload.add("heater_on", digitalRead(HEATER_PIN) == HIGH);
 
     Serial.print("Sending: ");
-    Serial.println(jsonPayload);
+    Serial.println(payload.c_str());
 
     // Send payload - commands are automatically dispatched to handlers
-    bool success = inventronix.sendPayload(jsonPayload.c_str());
+    bool success = inventronix.sendPayload(payload);
 
     if (success) {
         Serial.println("Data sent successfully\n");
@@ -0,0 +1,104 @@
+/**
+ * Inventronix Latency Benchmark
+ *
+ * Sends payloads to a mock ingest server on your network and prints
+ * p50/p95/p99 for each phase of sendPayload(): WiFi check, DNS, connect
+ * (with a reference TCP connect and a TLS estimate), request write, time
+ * to first byte, headers, body read, JSON parse and command dispatch. See
+ * LatencyProbe.h for how each phase is measured.
+ *
+ * The "csv," lines match those of the host benchmark
+ * (extras/bench/latency_bench.cpp). Save them before and after a change to
+ * the send path and diff them.
+ *
+ * Supported Hardware:
+ * - ESP32
+ * - Arduino UNO R4 WiFi (verifies certificates, so the mock needs one the
+ *   module trusts)
+ *
+ * Setup:
+ * 1. On a computer on the same network, make a certificate and start the mock
+ *    (commands per response and their size are set here):
+ *      openssl req -x509 -newkey rsa:2048 -nodes -days 365 -subj /CN=mock \
+ *          -keyout mock.key -out mock.crt
+ *      python3 extras/bench/mock_ingest.py --port 8443 --tls mock.crt mock.key \
+ *          --commands 4 --command-bytes 64
+ * 2. Update the WiFi credentials, MOCK_HOST and MOCK_PORT below
+ * 3. Upload and open Serial Monitor (115200 baud)
+ */
+
+#include <Inventronix.h>
+#include "LatencyProbe.h"
+
+// WiFi credentials
+#define WIFI_SSID "your-wifi-ssid"
+#define WIFI_PASSWORD "your-wifi-password"
+
+// Machine running extras/bench/mock_ingest.py
+#define MOCK_HOST "192.168.1.20"
+#define MOCK_PORT 8443
+
+#define PAYLOAD_BYTES 256           // Size of each payload
+#define WARMUP 5                    // Requests before recording starts
+#define ITERATIONS 100              // Requests per report
+#define PARSE_ARENA_SIZE 4096       // Enough for the mock's largest response
+
+Inventronix inventronix;
+InventronixPlatformTransport transport;
+LatencyProbe probe(transport, MOCK_HOST, MOCK_PORT);
+
+char payload[PAYLOAD_BYTES + 32];
+uint32_t seq = 0;
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n\n=================================");
+    Serial.println("Inventronix Latency Benchmark");
+    Serial.println("=================================\n");
+
+    if (!probe.begin(ITERATIONS)) {
+        Serial.println("Not enough memory for the samples!");
+        while (true) delay(1000);  // Halt
+    }
+
+    inventronix.begin("proj_bench", "key_bench", PARSE_ARENA_SIZE);
+    inventronix.setVerboseLogging(false);
+    inventronix.setRetryAttempts(1);
+    inventronix.setCommandAcks(false);     // Keep every payload the same size
+    inventronix.setTransport(&probe);
+
+    // The mock's commands are all "bench"; the probe times their dispatch
+    inventronix.onCommand("bench", [](JsonObject) {
+        probe.commandStarted();
+    });
+
+    if (!inventronix.connectWiFi(WIFI_SSID, WIFI_PASSWORD)) {
+        Serial.println("Failed to connect to WiFi!");
+        while (true) delay(1000);  // Halt
+    }
+}
+
+void loop() {
+    for (int i = 0; i < WARMUP; i++) {
+        probe.send(inventronix, latencyPayload(payload, PAYLOAD_BYTES, seq++));
+    }
+    probe.reset();
+
+    for (int i = 0; i < ITERATIONS; i++) {
+        probe.send(inventronix, latencyPayload(payload, PAYLOAD_BYTES, seq++));
+        inventronix.loop();
+    }
+
+    char label[48];
+#if defined(ARDUINO_UNOR4_WIFI)
+    snprintf(label, sizeof(label), "uno_r4 payload=%d", PAYLOAD_BYTES);
+#else
+    snprintf(label, sizeof(label), "esp32 payload=%d", PAYLOAD_BYTES);
+#endif
+    probe.report(Serial, label);
+    Serial.println();
+
+    delay(10000);
+}
@@ -0,0 +1,331 @@
+/**
+ * LatencyProbe: per-phase timing of sendPayload()
+ *
+ * A transport that wraps the real one and timestamps each step of a request.
+ * Network phases are timed around the transport calls. Library phases are
+ * taken from the gaps between them:
+ * - WiFi check: from sendPayload() up to open()
+ * - JSON parse: from close() up to the first command handler
+ * - dispatch: from that handler until sendPayload() returns
+ *
+ * DNS is a WiFi.hostByName() lookup made just before open(), so the
+ * library's own lookup is answered from the resolver cache. "connect" is
+ * the whole of open(): TCP connect plus TLS handshake, which the platform
+ * clients do in one call. To split it, the boards also time a bare
+ * WiFiClient connect to the same address and port ("tcp_reference", a
+ * separate connection, left out of the total), and "tls_estimate" is
+ * connect minus that. The host build has no TLS, so both read n/a there.
+ *
+ * "headers" is reading the response headers, "body_read" the body plus
+ * close(). ESP32's HTTPClient reads the status and headers while
+ * sending, so time to first byte and headers land in request write there.
+ *
+ * Shared by LatencyBench.ino and extras/bench/latency_bench.cpp.
+ */
+
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <Inventronix.h>
+#include <new>
+#include <stdlib.h>
+
+enum LatencyPhase : uint8_t {
+    PHASE_WIFI_CHECK,
+    PHASE_DNS,
+    PHASE_CONNECT,
+    PHASE_TCP_REFERENCE,
+    PHASE_TLS_ESTIMATE,
+    PHASE_REQUEST_WRITE,
+    PHASE_FIRST_BYTE,
+    PHASE_HEADERS,
+    PHASE_BODY_READ,
+    PHASE_JSON_PARSE,
+    PHASE_DISPATCH,
+    PHASE_TOTAL,
+    PHASE_COUNT
+};
+
+static const char* const LATENCY_PHASE_NAMES[PHASE_COUNT] = {
+    "wifi_check", "dns", "connect", "tcp_reference", "tls_estimate", "request_write",
+    "first_byte", "headers", "body_read", "json_parse", "dispatch", "total"
+};
+
+// JSON object of about `size` bytes: {"seq":N,"pad":"xxx..."}
+inline const char* latencyPayload(char* out, size_t size, uint32_t seq) {
+    String head = String("{\"seq\":") + String((unsigned long)seq) + ",\"pad\":\"";
+    size_t length = head.length();
+    if (size < length + 3) {
+        size = length + 3;
+    }
+    memcpy(out, head.c_str(), length);
+    while (length < size - 2) {
+        out[length++] = 'x';
+    }
+    out[length++] = '"';
+    out[length++] = '}';
+    out[length] = '\0';
+    return out;
+}
+
+class LatencyProbe : public InventronixTransport {
+public:
+    // `host`/`port` send every request there instead (e.g. a mock server on
+    // the LAN); nullptr keeps the library's own
+    explicit LatencyProbe(InventronixTransport& inner, const char* host = nullptr, uint16_t port = 0)
+        : _inner(inner), _host(host), _port(port), _samples(nullptr), _scratch(nullptr),
+          _capacity(0), _failures(0) {
+        reset();
+    }
+
+    ~LatencyProbe() {
+        delete[] _samples;
+        delete[] _scratch;
+    }
+
+    // Room for `capacity` requests per phase
+    bool begin(uint16_t capacity) {
+        delete[] _samples;
+        delete[] _scratch;
+        _samples = new (std::nothrow) uint32_t[(size_t)capacity * PHASE_COUNT];
+        _scratch = new (std::nothrow) uint32_t[capacity];
+        _capacity = (_samples && _scratch) ? capacity : 0;
+        reset();
+        return _capacity > 0;
+    }
+
+    // Forget every recorded request
+    void reset() {
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            _counts[i] = 0;
+        }
+        _failures = 0;
+    }
+
+    // Time one sendPayload(). Failed sends are counted, not recorded.
+    bool send(Inventronix& client, const char* payload) {
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            _current[i] = 0;
+            _have[i] = false;
+        }
+        _firstCommandAt = 0;
+        _closedAt = 0;
+        _referenceUs = 0;
+        _sendStart = micros();
+        bool ok = client.sendPayload(payload);
+        uint32_t end = micros();
+
+        if (!ok || _closedAt == 0) {
+            _failures++;
+            return false;
+        }
+        mark(PHASE_JSON_PARSE, (_firstCommandAt ? _firstCommandAt : end) - _closedAt);
+        if (_firstCommandAt) {
+            mark(PHASE_DISPATCH, end - _firstCommandAt);
+        }
+        mark(PHASE_TOTAL, end - _sendStart - _referenceUs);
+
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            if (_have[i] && _counts[i] < _capacity) {
+                _samples[(size_t)i * _capacity + _counts[i]++] = _current[i];
+            }
+        }
+        return true;
+    }
+
+    // Call first thing in every command handler
+    void commandStarted() {
+        if (_firstCommandAt == 0) {
+            _firstCommandAt = micros();
+        }
+    }
+
+    uint16_t recorded() const { return _counts[PHASE_TOTAL]; }
+    uint16_t failures() const { return _failures; }
+
+    // Table of p50/p95/p99 per phase, then the same as "csv," lines for diffing runs
+    void report(Print& out, const char* label) {
+        uint32_t p[PHASE_COUNT][3];
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            percentiles((LatencyPhase)i, p[i]);
+        }
+
+        out.print("== ");
+        out.print(label);
+        out.print(" (");
+        out.print((unsigned int)recorded());
+        out.print(" requests, ");
+        out.print((unsigned int)_failures);
+        out.println(" failed)");
+        out.println("phase              p50_us    p95_us    p99_us");
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            printPadded(out, LATENCY_PHASE_NAMES[i], 15, false);
+            for (int k = 0; k < 3; k++) {
+                if (_counts[i] == 0) {
+                    printPadded(out, "n/a", 10, true);
+                } else {
+                    printPadded(out, String((unsigned long)p[i][k]).c_str(), 10, true);
+                }
+            }
+            out.println();
+        }
+        for (int i = 0; i < PHASE_COUNT; i++) {
+            if (_counts[i] == 0) {
+                continue;
+            }
+            out.print("csv,");
+            out.print(label);
+            out.print(",");
+            out.print(LATENCY_PHASE_NAMES[i]);
+            for (int k = 0; k < 3; k++) {
+                out.print(",");
+                out.print((unsigned long)p[i][k]);
+            }
+            out.print(",");
+            out.println((unsigned int)_counts[i]);
+        }
+    }
+
+    // InventronixTransport
+    int open(const char* host, uint16_t port, bool secure) override {
+        uint32_t start = micros();
+        mark(PHASE_WIFI_CHECK, start - _sendStart);
+        if (_host) {
+            host = _host;
+            port = _port;
+        }
+
+        IPAddress ip;
+        bool resolved = WiFi.hostByName(host, ip) == 1;
+        mark(PHASE_DNS, micros() - start);
+
+#ifdef INVENTRONIX_PLATFORM_HOST
+        (void)resolved;
+#else
+        // Reference connect on its own socket - not part of the request
+        uint32_t tcpUs = 0;
+        if (resolved) {
+            WiFiClient bare;
+            start = micros();
+            if (bare.connect(ip, port)) {
+                tcpUs = micros() - start;
+                mark(PHASE_TCP_REFERENCE, tcpUs);
+            }
+            bare.stop();
+            _referenceUs = micros() - start;
+        }
+#endif
+
+        start = micros();
+        int result = _inner.open(host, port, secure);
+        uint32_t openUs = micros() - start;
+        mark(PHASE_CONNECT, openUs);
+#ifndef INVENTRONIX_PLATFORM_HOST
+        if (secure && tcpUs > 0) {
+            mark(PHASE_TLS_ESTIMATE, openUs > tcpUs ? openUs - tcpUs : 0);
+        }
+#endif
+        return result;
+    }
+
+    int writeRequest(const InventronixRequest& request) override {
+        uint32_t start = micros();
+        int result = _inner.writeRequest(request);
+        mark(PHASE_REQUEST_WRITE, micros() - start);
+        return result;
+    }
+
+    int readStatus() override {
+        uint32_t start = micros();
+        int status = _inner.readStatus();
+        mark(PHASE_FIRST_BYTE, micros() - start);
+        return status;
+    }
+
+    bool readHeader(String& name, String& value) override {
+        uint32_t start = micros();
+        bool more = _inner.readHeader(name, value);
+        mark(PHASE_HEADERS, micros() - start);
+        return more;
+    }
+
+    int readBody(uint8_t* buffer, size_t size) override {
+        uint32_t start = micros();
+        int length = _inner.readBody(buffer, size);
+        mark(PHASE_BODY_READ, micros() - start);
+        return length;
+    }
+
+    void close() override {
+        uint32_t start = micros();
+        _inner.close();
+        _closedAt = micros();
+        if (_have[PHASE_BODY_READ]) {
+            mark(PHASE_BODY_READ, _closedAt - start);
+        }
+    }
+
+private:
+    InventronixTransport& _inner;
+    const char* _host;
+    uint16_t _port;
+
+    uint32_t* _samples;         // PHASE_COUNT rows of _capacity
+    uint32_t* _scratch;         // Sort buffer for one phase
+    uint16_t _capacity;
+    uint16_t _counts[PHASE_COUNT];
+    uint16_t _failures;
+
+    // Request in flight
+    uint32_t _current[PHASE_COUNT];
+    bool _have[PHASE_COUNT];
+    uint32_t _sendStart;
+    uint32_t _referenceUs;      // Spent on the reference connect, left out of the total
+    uint32_t _closedAt;
+    uint32_t _firstCommandAt;
+
+    void mark(LatencyPhase phase, uint32_t us) {
+        _current[phase] += us;
+        _have[phase] = true;
+    }
+
+    static int compareSamples(const void* a, const void* b) {
+        uint32_t x = *(const uint32_t*)a;
+        uint32_t y = *(const uint32_t*)b;
+        return (x > y) - (x < y);
+    }
+
+    // Nearest-rank p50, p95 and p99
+    void percentiles(LatencyPhase phase, uint32_t out[3]) {
+        uint16_t n = _counts[phase];
+        out[0] = out[1] = out[2] = 0;
+        if (n == 0) {
+            return;
+        }
+        memcpy(_scratch, _samples + (size_t)phase * _capacity, n * sizeof(uint32_t));
+        qsort(_scratch, n, sizeof(uint32_t), compareSamples);
+        static const uint8_t ranks[3] = {50, 95, 99};
+        for (int k = 0; k < 3; k++) {
+            uint32_t rank = ((uint32_t)ranks[k] * n + 99) / 100;
+            out[k] = _scratch[rank > 0 ? rank - 1 : 0];
+        }
+    }
+
+    static void printPadded(Print& out, const char* text, size_t width, bool right) {
+        size_t length = strlen(text);
+        if (!right) {
+            out.print(text);
+        }
+        for (size_t i = length; i < width; i++) {
+            out.print(' ');
+        }
+        if (right) {
+            out.print(text);
+        }
+    }
+
+    LatencyProbe(const LatencyProbe&) = delete;
+    LatencyProbe& operator=(const LatencyProbe&) = delete;
+};
+
+#endif
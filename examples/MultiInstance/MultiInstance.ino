@@ -0,0 +1,177 @@
+/**
+ * Inventronix Multiple Instances
+ *
+ * Two independent clients in one sketch - for example a gateway that uploads
+ * to two projects. Each instance has its own commands, pulses, pulse timer
+ * and ack buffer; nothing is shared between them.
+ *
+ * At startup the sketch runs a self-check: both instances register pulses
+ * with the SAME command names, then pulses are triggered interleaved across
+ * the two. Each pulse must run its own instance's callbacks, for its own
+ * duration, and pulsing one instance must not affect the other. After the
+ * check, the instances take turns sending payloads, so server commands for
+ * each project are dispatched to the right one.
+ *
+ * The same checks, plus command dispatch against a mock server, run on a
+ * desktop as extras/host/tests/multi_instance_test.cpp (ctest).
+ *
+ * Supported Hardware:
+ * - ESP32 (all variants)
+ * - Arduino UNO R4 WiFi
+ *
+ * Setup:
+ * 1. Update WiFi credentials and both projects' credentials below
+ * 2. In each project, add a rule that sends "valve" and "status_led" commands
+ * 3. Open Serial Monitor (115200 baud)
+ */
+
+#include <Inventronix.h>
+
+// WiFi credentials
+#define WIFI_SSID "your-wifi-ssid"
+#define WIFI_PASSWORD "your-wifi-password"
+
+// Inventronix credentials (get these from https://inventronix.club/iot-relay/projects)
+#define PROJECT_A_ID "proj_abc123"
+#define PROJECT_A_KEY "key_xyz789"
+#define PROJECT_B_ID "proj_def456"
+#define PROJECT_B_KEY "key_uvw012"
+
+// Each instance drives its own pins
+#define VALVE_A_PIN 4
+#define VALVE_B_PIN 5
+#define LED_A_PIN 6
+#define LED_B_PIN 7
+
+#define SEND_INTERVAL_MS 10000
+
+Inventronix clientA;
+Inventronix clientB;
+
+// What each instance's callbacks have seen
+struct Tally {
+    int pulseOn;
+    int pulseOff;
+    unsigned long lastOnMs;
+    unsigned long lastWidthMs;
+    int commands;
+};
+Tally tallyA;
+Tally tallyB;
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    Serial.print(ok ? "  PASS  " : "  FAIL  ");
+    Serial.println(what);
+    if (!ok) failures++;
+}
+
+// Register the same command names on one instance, wired to its own tally
+void registerCommands(Inventronix& client, Tally& tally, int valvePin, int ledPin) {
+    client.onPulse("dose", 0,
+        [&tally]() {
+            tally.pulseOn++;
+            tally.lastOnMs = millis();
+        },
+        [&tally]() {
+            tally.pulseOff++;
+            tally.lastWidthMs = millis() - tally.lastOnMs;
+        });
+
+    client.onPulse("valve", valvePin, 2000);
+
+    pinMode(ledPin, OUTPUT);
+    client.onCommand("status_led", [&tally, ledPin](JsonObject args) {
+        tally.commands++;
+        digitalWrite(ledPin, (args["on"] | true) ? HIGH : LOW);
+    });
+}
+
+// Run both instances' loops until `ms` has passed
+void runBoth(unsigned long ms) {
+    unsigned long start = millis();
+    while (millis() - start < ms) {
+        clientA.loop();
+        clientB.loop();
+    }
+}
+
+// Interleaved pulses on two instances with identical command names
+void selfCheck() {
+    Serial.println("Self-check: interleaved pulses on two instances");
+
+    // A: 300ms, then B: 100ms while A is still on
+    check(clientA.triggerPulse("dose", 300), "A dose starts");
+    runBoth(50);
+    check(clientB.triggerPulse("dose", 100), "B dose starts while A is pulsing");
+    check(clientA.isPulsing("dose") && clientB.isPulsing("dose"), "both pulsing");
+    check(tallyA.pulseOn == 1 && tallyB.pulseOn == 1, "each on callback ran once, on its own instance");
+
+    // B ends first; A must keep going
+    runBoth(150);
+    check(!clientB.isPulsing("dose"), "B ended after its own duration");
+    check(clientA.isPulsing("dose"), "A still pulsing");
+    check(tallyB.pulseOff == 1 && tallyA.pulseOff == 0, "only B's off callback ran");
+
+    // A repeat on B does not touch A (A ignores repeats by default)
+    check(clientB.triggerPulse("dose", 100), "B dose restarts");
+    check(!clientA.triggerPulse("dose", 100), "A repeat is ignored while A is pulsing");
+
+    runBoth(250);
+    check(!clientA.isPulsing("dose") && !clientB.isPulsing("dose"), "both ended");
+    check(tallyA.pulseOff == 1 && tallyB.pulseOff == 2, "off callbacks matched their instances");
+    check(tallyA.lastWidthMs >= 295 && tallyA.lastWidthMs <= 320, "A width ~300ms");
+    check(tallyB.lastWidthMs >= 95 && tallyB.lastWidthMs <= 120, "B width ~100ms");
+
+    // Pin pulses on the same name drive different pins
+    clientA.triggerPulse("valve", 100);
+    runBoth(20);
+    check(digitalRead(VALVE_A_PIN) == HIGH && digitalRead(VALVE_B_PIN) == LOW, "A valve pin only");
+    runBoth(100);
+    check(digitalRead(VALVE_A_PIN) == LOW, "A valve pin off");
+
+    Serial.print(failures == 0 ? "Self-check passed" : "Self-check FAILED: ");
+    if (failures > 0) Serial.print(failures);
+    Serial.println();
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    clientA.begin(PROJECT_A_ID, PROJECT_A_KEY);
+    clientB.begin(PROJECT_B_ID, PROJECT_B_KEY);
+    registerCommands(clientA, tallyA, VALVE_A_PIN, LED_A_PIN);
+    registerCommands(clientB, tallyB, VALVE_B_PIN, LED_B_PIN);
+
+    selfCheck();
+
+    // One WiFi link serves both clients
+    clientA.connectWiFi(WIFI_SSID, WIFI_PASSWORD);
+}
+
+void loop() {
+    static unsigned long lastSend = 0;
+    static bool sendA = true;
+
+    clientA.loop();
+    clientB.loop();
+
+    // Alternate uploads; each response's commands go to the instance that sent it
+    if (millis() - lastSend >= SEND_INTERVAL_MS / 2) {
+        lastSend = millis();
+        Inventronix& client = sendA ? clientA : clientB;
+        Tally& tally = sendA ? tallyA : tallyB;
+
+        Inventronix::Payload& payload = client.beginPayload();
+        payload.add("uptime_s", (long)(millis() / 1000));
+        payload.add("commands", tally.commands);
+        client.sendPayload(payload);
+
+        Serial.print(sendA ? "A" : "B");
+        Serial.print(" commands handled: ");
+        Serial.println(tally.commands);
+        sendA = !sendA;
+    }
+}
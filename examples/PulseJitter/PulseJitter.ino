@@ -0,0 +1,189 @@
+/**
+ * Inventronix Pulse Jitter Harness
+ *
+ * Measures how far real pulse widths stray from the requested width, for a
+ * normal pulse (onPulse) and a hardware-timed one (onPrecisionPulse), while
+ * the sketch keeps WiFi busy by sending payloads.
+ *
+ * Each output pin is jumpered to an interrupt-capable input pin, and the
+ * input interrupt timestamps both edges with micros(). Every SAMPLES pulses
+ * per mode, the sketch prints the min / max / mean error in microseconds.
+ * (The capture interrupt itself adds a few microseconds of noise.)
+ *
+ * Supported Hardware:
+ * - ESP32 (arduino-esp32 3.x for RMT precision pulses)
+ * - Arduino UNO R4 WiFi
+ *
+ * Wiring:
+ *   STD_OUT_PIN     -> STD_IN_PIN
+ *   PRECISE_OUT_PIN -> PRECISE_IN_PIN
+ *
+ * Setup:
+ * 1. Update WiFi credentials, PROJECT_ID and API_KEY below
+ * 2. Wire the pins as above and upload
+ * 3. Open Serial Monitor (115200 baud)
+ */
+
+#include <Inventronix.h>
+
+// WiFi credentials
+#define WIFI_SSID "your-wifi-ssid"
+#define WIFI_PASSWORD "your-wifi-password"
+
+// Inventronix credentials (get these from https://inventronix.club/iot-relay/projects)
+#define PROJECT_ID "proj_abc123"
+#define API_KEY "key_xyz789"
+
+// Pins (inputs must support attachInterrupt)
+#if defined(ARDUINO_UNOR4_WIFI)
+#define STD_OUT_PIN 4
+#define STD_IN_PIN 2
+#define PRECISE_OUT_PIN 6
+#define PRECISE_IN_PIN 3
+#else
+#define STD_OUT_PIN 4
+#define STD_IN_PIN 5
+#define PRECISE_OUT_PIN 6
+#define PRECISE_IN_PIN 7
+#endif
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+#define PULSE_MS 20                 // Requested pulse width
+#define PULSE_GAP_MS 100            // Idle time between pulses
+#define LOAD_INTERVAL_MS 2000       // How often to send a payload (WiFi load)
+#define SAMPLES 50                  // Pulses per mode per report
+
+Inventronix inventronix;
+
+// Edge capture, written by the input interrupts
+struct Capture {
+    volatile unsigned long riseUs;
+    volatile unsigned long widthUs;
+    volatile bool ready;
+};
+Capture stdCapture;
+Capture preciseCapture;
+
+// Running error statistics per mode
+struct Stats {
+    long minErrorUs;
+    long maxErrorUs;
+    long long totalAbsErrorUs;
+    int count;
+};
+Stats stdStats;
+Stats preciseStats;
+
+void IRAM_ATTR captureEdge(Capture& capture, int pin) {
+    unsigned long now = micros();
+    if (digitalRead(pin) == HIGH) {
+        capture.riseUs = now;
+    } else {
+        capture.widthUs = now - capture.riseUs;
+        capture.ready = true;
+    }
+}
+
+void IRAM_ATTR onStdEdge() { captureEdge(stdCapture, STD_IN_PIN); }
+void IRAM_ATTR onPreciseEdge() { captureEdge(preciseCapture, PRECISE_IN_PIN); }
+
+void resetStats(Stats& stats) {
+    stats.minErrorUs = 2147483647L;
+    stats.maxErrorUs = -2147483647L;
+    stats.totalAbsErrorUs = 0;
+    stats.count = 0;
+}
+
+void record(Stats& stats, Capture& capture) {
+    if (!capture.ready) return;
+    capture.ready = false;
+
+    long error = (long)capture.widthUs - PULSE_MS * 1000L;
+    if (error < stats.minErrorUs) stats.minErrorUs = error;
+    if (error > stats.maxErrorUs) stats.maxErrorUs = error;
+    stats.totalAbsErrorUs += (error < 0) ? -error : error;
+    stats.count++;
+}
+
+void report(const char* name, const Stats& stats) {
+    Serial.print(name);
+    Serial.print(": min ");
+    Serial.print(stats.minErrorUs);
+    Serial.print("us, max ");
+    Serial.print(stats.maxErrorUs);
+    Serial.print("us, mean |error| ");
+    Serial.print((long)(stats.totalAbsErrorUs / stats.count));
+    Serial.println("us");
+}
+
+void setup() {
+    Serial.begin(115200);
+    delay(1000);
+
+    Serial.println("\n\n=================================");
+    Serial.println("Inventronix Pulse Jitter Harness");
+    Serial.println("=================================\n");
+
+    inventronix.begin(PROJECT_ID, API_KEY);
+    inventronix.setVerboseLogging(false);
+
+    if (!inventronix.connectWiFi(WIFI_SSID, WIFI_PASSWORD)) {
+        Serial.println("Failed to connect to WiFi!");
+        while (true) delay(1000);  // Halt
+    }
+
+    inventronix.onPulse("std_pulse", STD_OUT_PIN, PULSE_MS);
+    inventronix.onPrecisionPulse("precise_pulse", PRECISE_OUT_PIN, PULSE_MS);
+
+    pinMode(STD_IN_PIN, INPUT);
+    pinMode(PRECISE_IN_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(STD_IN_PIN), onStdEdge, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(PRECISE_IN_PIN), onPreciseEdge, CHANGE);
+
+    resetStats(stdStats);
+    resetStats(preciseStats);
+
+    Serial.print("Requested width: ");
+    Serial.print(PULSE_MS);
+    Serial.println("ms\n");
+}
+
+void loop() {
+    static unsigned long lastPulse = 0;
+    static unsigned long lastLoad = 0;
+    static bool precise = false;
+
+    // Required for pulse timing on Arduino UNO R4
+    inventronix.loop();
+
+    record(stdStats, stdCapture);
+    record(preciseStats, preciseCapture);
+
+    // Alternate modes, one pulse at a time
+    bool busy = inventronix.isPulsing("std_pulse") || inventronix.isPulsing("precise_pulse");
+    if (!busy && millis() - lastPulse >= PULSE_GAP_MS) {
+        inventronix.triggerPulse(precise ? "precise_pulse" : "std_pulse");
+        precise = !precise;
+        lastPulse = millis();
+    }
+
+    // Keep WiFi busy - this is the load the pulses have to survive
+    if (millis() - lastLoad >= LOAD_INTERVAL_MS) {
+        Inventronix::Payload& payload = inventronix.beginPayload();
+        payload.add("std_samples", stdStats.count);
+        payload.add("precise_samples", preciseStats.count);
+        inventronix.sendPayload(payload);
+        lastLoad = millis();
+    }
+
+    if (stdStats.count >= SAMPLES && preciseStats.count >= SAMPLES) {
+        report("onPulse         ", stdStats);
+        report("onPrecisionPulse", preciseStats);
+        Serial.println();
+        resetStats(stdStats);
+        resetStats(preciseStats);
+    }
+}
@@ -0,0 +1,95 @@
+/**
+ * Command dispatch microbenchmark (host)
+ *
+ * Measures the cost of resolving an incoming command name to its handler
+ * with the old linear scan (string compare against every registered name)
+ * and with InventronixDispatchIndex, at 16, 256 and 4096 handlers.
+ *
+ * Build and run from the repository root:
+ *   g++ -O2 -std=c++11 -Isrc extras/bench/dispatch_bench.cpp src/InventronixDispatch.cpp -o dispatch_bench
+ *   ./dispatch_bench
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "InventronixDispatch.h"
+
+static volatile long g_sink;
+
+// What dispatchCommand/isPulsing did: compare against every name in turn
+static int linearFind(const std::vector<std::string>& names, const char* command) {
+    for (size_t i = 0; i < names.size(); i++) {
+        if (strcmp(names[i].c_str(), command) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+template <typename Fn>
+static double nsPerLookup(const std::vector<const char*>& queries, int rounds, Fn fn) {
+    long total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (const char* q : queries) {
+            total += fn(q);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    g_sink = total;
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           ((double)queries.size() * rounds);
+}
+
+static void runSize(size_t handlers, std::mt19937& rng) {
+    // Realistic command names sharing a common prefix, like "relay_12_on"
+    std::vector<std::string> names;
+    for (size_t i = 0; i < handlers; i++) {
+        names.push_back("relay_" + std::to_string(i) + (i % 2 ? "_on" : "_off"));
+    }
+
+    InventronixDispatchIndex index;
+    for (size_t i = 0; i < handlers; i++) {
+        index.insert(InventronixDispatchIndex::hash(names[i].c_str()), (uint16_t)i);
+    }
+
+    // 90% hits spread over the registry, 10% unknown commands
+    std::vector<std::string> missNames;
+    for (int i = 0; i < 64; i++) {
+        missNames.push_back("unknown_cmd_" + std::to_string(i));
+    }
+    std::vector<const char*> queries;
+    std::uniform_int_distribution<size_t> pick(0, handlers - 1);
+    for (int i = 0; i < 1000; i++) {
+        queries.push_back(i % 10 == 0 ? missNames[i % missNames.size()].c_str()
+                                      : names[pick(rng)].c_str());
+    }
+
+    int rounds = handlers >= 4096 ? 20 : 2000;
+
+    double linear = nsPerLookup(queries, rounds, [&](const char* q) {
+        return linearFind(names, q);
+    });
+    double hashed = nsPerLookup(queries, rounds, [&](const char* q) {
+        return index.find(InventronixDispatchIndex::hash(q), [&](uint16_t v) {
+            return strcmp(names[v].c_str(), q) == 0;
+        });
+    });
+
+    printf("%6zu handlers   linear %10.1f ns   hashed %6.1f ns   %8.1fx\n",
+           handlers, linear, hashed, linear / hashed);
+}
+
+int main() {
+    std::mt19937 rng(42);
+    printf("Command lookup cost per dispatch (90%% hits, 10%% unknown)\n");
+    runSize(16, rng);
+    runSize(256, rng);
+    runSize(4096, rng);
+    return 0;
+}
@@ -0,0 +1,182 @@
+/**
+ * Number formatting microbenchmark (host)
+ *
+ * Compares the library's integer-only formatters against the paths payloads
+ * used to go through:
+ * - Arduino Print::printFloat (what Serial.print / String(float) do)
+ * - snprintf("%.9g")
+ * - ArduinoJson serializeJson, when ArduinoJson.h is on the include path
+ *
+ * formatFloat is what Payload::add(key, float) uses; formatFloatShortest is
+ * the opt-in Payload::addShortest path. Also checks that formatFloatShortest
+ * round-trips every value it formats.
+ *
+ * Build and run from the repository root:
+ *   g++ -O2 -std=c++11 -Isrc extras/bench/format_bench.cpp src/InventronixFormat.cpp -o format_bench
+ *   ./format_bench
+ *
+ * Note: a desktop CPU has an FPU, so this understates the gap on FPU-less
+ * targets like the ESP32-C3, where every float op in the baseline paths is
+ * a soft-float library call.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "InventronixFormat.h"
+
+#if defined(__has_include)
+#if __has_include(<ArduinoJson.h>)
+#include <ArduinoJson.h>
+#define BENCH_HAVE_ARDUINOJSON
+#endif
+#endif
+
+static volatile size_t g_sink;
+
+// Arduino core Print::printFloat, writing into a buffer instead of a stream
+static size_t arduinoPrintFloat(char* out, double number, uint8_t digits) {
+    size_t n = 0;
+    if (std::isnan(number)) return (size_t)snprintf(out, 8, "nan");
+    if (std::isinf(number)) return (size_t)snprintf(out, 8, "inf");
+    if (number > 4294967040.0 || number < -4294967040.0) return (size_t)snprintf(out, 8, "ovf");
+
+    if (number < 0.0) {
+        out[n++] = '-';
+        number = -number;
+    }
+
+    double rounding = 0.5;
+    for (uint8_t i = 0; i < digits; ++i) {
+        rounding /= 10.0;
+    }
+    number += rounding;
+
+    unsigned long intPart = (unsigned long)number;
+    double remainder = number - (double)intPart;
+    n += (size_t)snprintf(out + n, 16, "%lu", intPart);
+
+    if (digits > 0) {
+        out[n++] = '.';
+    }
+    while (digits-- > 0) {
+        remainder *= 10.0;
+        unsigned int toPrint = (unsigned int)remainder;
+        out[n++] = (char)('0' + toPrint);
+        remainder -= toPrint;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+template <typename Fn>
+static double nsPerOp(const std::vector<float>& values, int rounds, Fn fn) {
+    char buffer[64];
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (float v : values) {
+            total += fn(buffer, v);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    g_sink = total;
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    return ns / ((double)values.size() * rounds);
+}
+
+static void report(const char* name, double ns, double baseline) {
+    printf("  %-34s %8.1f ns/op  %6.2fx\n", name, ns, baseline / ns);
+}
+
+static void runSuite(const char* title, const std::vector<float>& values, int rounds) {
+    printf("%s (%zu values x %d rounds)\n", title, values.size(), rounds);
+
+    double baseline = nsPerOp(values, rounds, [](char* b, float v) {
+        return arduinoPrintFloat(b, v, 2);
+    });
+    report("Print::printFloat (2 decimals)", baseline, baseline);
+
+    report("snprintf %.9g", nsPerOp(values, rounds, [](char* b, float v) {
+        return (size_t)snprintf(b, 64, "%.9g", v);
+    }), baseline);
+
+#ifdef BENCH_HAVE_ARDUINOJSON
+    report("ArduinoJson serializeJson", nsPerOp(values, rounds, [](char* b, float v) {
+        JsonDocument doc;
+        doc.set(v);
+        return serializeJson(doc, b, 64);
+    }), baseline);
+#endif
+
+    report("formatFloat (2 decimals)", nsPerOp(values, rounds, [](char* b, float v) {
+        return InventronixFormat::formatFloat(b, v, 2);
+    }), baseline);
+
+    report("formatFloatShortest", nsPerOp(values, rounds, [](char* b, float v) {
+        return InventronixFormat::formatFloatShortest(b, v);
+    }), baseline);
+
+    // Fixed-point: the sensor already hands us centi-units
+    std::vector<int32_t> raw;
+    for (float v : values) raw.push_back(InventronixFormat::toFixed(v, 2));
+    char buffer[64];
+    size_t total = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (int32_t v : raw) {
+            total += InventronixFormat::formatFixed(buffer, v, 2, 2);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    g_sink = total;
+    double ns = std::chrono::duration<double, std::nano>(end - start).count() / ((double)raw.size() * rounds);
+    report("formatFixed (raw int, scale 2)", ns, baseline);
+    printf("\n");
+}
+
+static bool checkRoundTrip(const std::vector<float>& values) {
+    char buffer[64];
+    for (float v : values) {
+        InventronixFormat::formatFloatShortest(buffer, v);
+        float parsed = strtof(buffer, nullptr);
+        if (parsed != v) {
+            printf("Round-trip failure: %.9g -> %s\n", v, buffer);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::mt19937 rng(12345);
+
+    // Typical sensor readings: 0-100 with a couple of decimals
+    std::vector<float> sensor;
+    std::uniform_int_distribution<int> centi(-2000, 10000);
+    for (int i = 0; i < 4096; i++) {
+        sensor.push_back(centi(rng) / 100.0f);
+    }
+
+    // Arbitrary finite floats across the whole exponent range
+    std::vector<float> wide;
+    std::uniform_int_distribution<uint32_t> bits;
+    while (wide.size() < 4096) {
+        uint32_t b = bits(rng);
+        float v;
+        memcpy(&v, &b, sizeof(v));
+        if (std::isfinite(v)) wide.push_back(v);
+    }
+
+    runSuite("Sensor-range values", sensor, 200);
+    runSuite("Full-range values", wide, 50);
+
+    bool ok = checkRoundTrip(sensor) && checkRoundTrip(wide);
+    printf("Shortest round-trip check: %s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
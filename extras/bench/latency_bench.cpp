@@ -0,0 +1,231 @@
+/**
+ * End-to-end sendPayload() latency benchmark (host)
+ *
+ * Runs the library's real send path (the UNO R4 code over the host shim,
+ * see "Host Build" in README.md) against a mock ingest server in this
+ * process, and reports p50/p95/p99 per phase through LatencyProbe
+ * (examples/LatencyBench/LatencyProbe.h): WiFi check, DNS, connect,
+ * request write, time to first byte, headers, body read, JSON parse and
+ * dispatch. TLS is not emulated on the host, so the TCP reference and TLS
+ * estimate rows read n/a.
+ *
+ * Every payload size is run against every command-response shape. Each
+ * response carries `commands` commands whose arguments are padded to about
+ * `command-bytes` bytes.
+ *
+ * Build and run from the repository root:
+ *   cmake -S . -B build && cmake --build build
+ *   ./build/latency_bench [--iterations 500] [--payload 64,512,2048]
+ *                         [--commands 0,4] [--command-bytes 64]
+ *
+ * The "csv," lines can be kept and diffed to compare two builds of the send
+ * path. The same probe runs on a board in examples/LatencyBench.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Inventronix.h>
+#include "LatencyProbe.h"
+
+// ============================================
+// MOCK INGEST SERVER
+// ============================================
+
+// Shape of the next responses (changed between runs)
+static std::atomic<int> s_commands(0);
+static std::atomic<int> s_commandBytes(64);
+static std::atomic<unsigned long> s_requests(0);
+
+// {"commands":[{"command":"bench","execution_id":"r<N>-<i>","arguments":{"pad":"xx..."}}, ...]}
+static std::string mockResponse(unsigned long request) {
+    std::string body = "{\"commands\":[";
+    int commands = s_commands;
+    for (int i = 0; i < commands; i++) {
+        if (i > 0) body += ",";
+        body += "{\"command\":\"bench\",\"execution_id\":\"r" + std::to_string(request) + "-" +
+                std::to_string(i) + "\",\"arguments\":{\"pad\":\"";
+        body.append((size_t)s_commandBytes, 'x');
+        body += "\"}}";
+    }
+    body += "]}";
+    return body;
+}
+
+// Read one request (headers, then Content-Length bytes of body)
+static bool readRequest(int fd) {
+    std::string data;
+    char buffer[4096];
+    size_t headerEnd = std::string::npos;
+    long contentLength = 0;
+    for (;;) {
+        if (headerEnd == std::string::npos) {
+            headerEnd = data.find("\r\n\r\n");
+            if (headerEnd != std::string::npos) {
+                const char* field = strcasestr(data.c_str(), "\r\nContent-Length:");
+                if (field && field < data.c_str() + headerEnd) {
+                    contentLength = atol(field + 17);
+                }
+            }
+        }
+        if (headerEnd != std::string::npos && data.size() >= headerEnd + 4 + (size_t)contentLength) {
+            return true;
+        }
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            return false;
+        }
+        data.append(buffer, (size_t)n);
+    }
+}
+
+static void serveMock(int listener) {
+    for (;;) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        if (readRequest(fd)) {
+            std::string body = mockResponse(++s_requests);
+            std::string response =
+                "HTTP/1.1 200 OK\r\n"
+                "Date: Sat, 17 Oct 2026 12:00:00 GMT\r\n"
+                "Content-Type: application/json\r\n"
+                "Connection: close\r\n"
+                "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+            send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+        }
+        close(fd);
+    }
+}
+
+// Listen on an ephemeral loopback port and point the host shim at it
+static bool startMock() {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (listener < 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(listener, 64) != 0 || getsockname(listener, (struct sockaddr*)&address, &length) != 0) {
+        perror("mock server");
+        return false;
+    }
+    std::string server = "127.0.0.1:" + std::to_string(ntohs(address.sin_port));
+    setenv("INVENTRONIX_HOST_SERVER", server.c_str(), 1);
+    std::thread(serveMock, listener).detach();
+    return true;
+}
+
+// ============================================
+// BENCHMARK
+// ============================================
+
+Inventronix inventronix;
+
+static std::vector<int> parseList(const char* text) {
+    std::vector<int> values;
+    for (const char* p = text; *p;) {
+        values.push_back(atoi(p));
+        const char* comma = strchr(p, ',');
+        if (!comma) break;
+        p = comma + 1;
+    }
+    return values;
+}
+
+int main(int argc, char** argv) {
+    int iterations = 500;
+    int warmup = 20;
+    int commandBytes = 64;
+    std::vector<int> payloads = {64, 512, 2048};
+    std::vector<int> commandCounts = {0, 4};
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (!strcmp(argv[i], "--iterations")) iterations = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--warmup")) warmup = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--payload")) payloads = parseList(argv[i + 1]);
+        else if (!strcmp(argv[i], "--commands")) commandCounts = parseList(argv[i + 1]);
+        else if (!strcmp(argv[i], "--command-bytes")) commandBytes = atoi(argv[i + 1]);
+        else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (iterations <= 0 || iterations > 65535) {
+        fprintf(stderr, "--iterations must be 1-65535\n");
+        return 2;
+    }
+    if (!startMock()) {
+        return 1;
+    }
+
+    // Parse arena big enough for the largest response
+    int maxCommands = 0;
+    for (int count : commandCounts) {
+        if (count > maxCommands) maxCommands = count;
+    }
+    size_t arenaSize = 2 * (size_t)maxCommands * (commandBytes + 128) + 1024;
+    if (arenaSize < INVENTRONIX_PARSE_ARENA_SIZE) {
+        arenaSize = INVENTRONIX_PARSE_ARENA_SIZE;
+    }
+
+    InventronixPlatformTransport transport;
+    LatencyProbe probe(transport);
+    if (!probe.begin((uint16_t)iterations)) {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    inventronix.setVerboseLogging(false);
+    inventronix.begin("proj_bench", "key_bench", arenaSize);
+    inventronix.setRetryAttempts(1);
+    inventronix.setCommandAcks(false);     // Keep every payload the same size
+    inventronix.setTransport(&probe);
+    inventronix.onCommand("bench", [&probe](JsonObject) {
+        probe.commandStarted();
+    });
+    if (!inventronix.connectWiFi("bench", "")) {
+        fprintf(stderr, "WiFi shim did not come up\n");
+        return 1;
+    }
+
+    uint32_t seq = 0;
+    for (int payloadBytes : payloads) {
+        std::vector<char> payload((size_t)payloadBytes + 64);
+        for (int commands : commandCounts) {
+            s_commands = commands;
+            s_commandBytes = commandBytes;
+
+            for (int i = 0; i < warmup; i++) {
+                probe.send(inventronix, latencyPayload(payload.data(), payloadBytes, seq++));
+            }
+            probe.reset();
+            for (int i = 0; i < iterations; i++) {
+                probe.send(inventronix, latencyPayload(payload.data(), payloadBytes, seq++));
+            }
+
+            char label[96];
+            snprintf(label, sizeof(label), "host payload=%d commands=%d command_bytes=%d",
+                     payloadBytes, commands, commandBytes);
+            probe.report(Serial, label);
+            Serial.println();
+        }
+    }
+    Serial.flush();
+    return 0;
+}
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""
+Mock ingest server for the on-device latency benchmark (examples/LatencyBench)
+
+Accepts POST /v1/iot/ingest like the real API and answers 200 with a
+configurable number of commands, each padded to a configurable size, so the
+board's JSON parse and dispatch phases can be measured. Execution ids are
+unique per response, so duplicate suppression never skips a command.
+
+The library's built-in transport always uses TLS, so serve with a
+certificate. ESP32 does not verify it, and a self-signed one is enough:
+
+    openssl req -x509 -newkey rsa:2048 -nodes -days 365 -subj /CN=mock \\
+        -keyout mock.key -out mock.crt
+    python3 extras/bench/mock_ingest.py --port 8443 --tls mock.crt mock.key \\
+        --commands 4 --command-bytes 64
+
+Without --tls it serves plain HTTP (e.g. for the host build's shim).
+"""
+
+import argparse
+import http.server
+import itertools
+import ssl
+import sys
+
+
+def make_handler(commands, command_bytes, verbose):
+    counter = itertools.count(1)
+
+    class IngestHandler(http.server.BaseHTTPRequestHandler):
+        protocol_version = "HTTP/1.1"
+
+        def do_POST(self):
+            length = int(self.headers.get("Content-Length", 0))
+            body = self.rfile.read(length)
+            request = next(counter)
+            if verbose:
+                sys.stderr.write("%s %d bytes\n" % (self.path, len(body)))
+
+            pad = "x" * command_bytes
+            items = ",".join(
+                '{"command":"bench","execution_id":"r%d-%d","arguments":{"pad":"%s"}}' % (request, i, pad)
+                for i in range(commands))
+            out = ('{"commands":[%s]}' % items).encode()
+
+            self.send_response(200)
+            self.send_header("Content-Type", "application/json")
+            self.send_header("Content-Length", str(len(out)))
+            self.send_header("Connection", "close")
+            self.end_headers()
+            self.wfile.write(out)
+            self.close_connection = True
+
+        def log_message(self, *args):
+            pass
+
+    return IngestHandler
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--commands", type=int, default=0, help="commands per response")
+    parser.add_argument("--command-bytes", type=int, default=64, help="argument padding per command")
+    parser.add_argument("--tls", nargs=2, metavar=("CERT", "KEY"), help="serve HTTPS")
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    server = http.server.ThreadingHTTPServer(
+        (args.bind, args.port), make_handler(args.commands, args.command_bytes, args.verbose))
+    if args.tls:
+        context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+        context.load_cert_chain(args.tls[0], args.tls[1])
+        server.socket = context.wrap_socket(server.socket, server_side=True)
+
+    print("mock ingest on %s:%d (%s, %d commands x %d bytes)" % (
+        args.bind, args.port, "https" if args.tls else "http", args.commands, args.command_bytes))
+    server.serve_forever()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,51 @@
+/**
+ * Host build example: send payloads to a local server
+ *
+ * Runs the library on Linux against INVENTRONIX_HOST_SERVER (default
+ * 127.0.0.1:8080), printing whatever the library logs and any command the
+ * server sends back. Handy for stepping through the request path in a
+ * debugger or checking changes without a board.
+ *
+ * Build and run from the repository root:
+ *   cmake -S . -B build && cmake --build build
+ *   INVENTRONIX_HOST_SERVER=127.0.0.1:8080 ./build/host_send [count]
+ */
+
+#include <Inventronix.h>
+
+Inventronix inventronix;
+
+int main(int argc, char** argv) {
+    int count = (argc > 1) ? atoi(argv[1]) : 3;
+
+    inventronix.begin("proj_host", "key_host");
+    inventronix.setVerboseLogging(true);
+    inventronix.setRetryAttempts(1);
+
+    inventronix.onCommand("print", [](JsonObject args) {
+        Serial.print("print command: ");
+        Serial.println(args["message"].as<const char*>());
+    });
+
+    if (!inventronix.connectWiFi("host", "")) {
+        Serial.println("WiFi shim did not come up");
+        return 1;
+    }
+
+    int failures = 0;
+    for (int i = 0; i < count; i++) {
+        Inventronix::Payload& payload = inventronix.beginPayload();
+        payload.add("seq", i);
+        payload.add("uptime_ms", (unsigned long)millis());
+        if (!inventronix.sendPayload(payload)) {
+            failures++;
+        }
+        inventronix.loop();
+    }
+
+    Serial.print("Sent ");
+    Serial.print(count - failures);
+    Serial.print("/");
+    Serial.println(count);
+    return failures == 0 ? 0 : 1;
+}
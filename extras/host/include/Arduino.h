@@ -0,0 +1,231 @@
+/**
+ * Arduino core shim for the Linux host build (see CMakeLists.txt)
+ *
+ * Just enough of the Arduino API for the library to build unchanged:
+ * String, Print/Stream/Client, Serial on stdout, millis()/micros() from the
+ * monotonic clock, and a simulated pin table behind pinMode()/digitalWrite().
+ * The RA4M1 register names used by output groups are backed by plain memory.
+ */
+
+#ifndef INVENTRONIX_HOST_ARDUINO_H
+#define INVENTRONIX_HOST_ARDUINO_H
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+#define DEC 10
+#define HEX 16
+
+// ============================================
+// STRING
+// ============================================
+
+class String {
+public:
+    String() {}
+    String(const char* text) : _text(text ? text : "") {}
+    String(const std::string& text) : _text(text) {}
+    explicit String(char c) : _text(1, c) {}
+    explicit String(int value, unsigned char base = 10) : _text(formatInteger(value, base)) {}
+    explicit String(unsigned int value, unsigned char base = 10) : _text(formatUnsigned(value, base)) {}
+    explicit String(long value, unsigned char base = 10) : _text(formatInteger(value, base)) {}
+    explicit String(unsigned long value, unsigned char base = 10) : _text(formatUnsigned(value, base)) {}
+    explicit String(float value, unsigned int decimals = 2) : _text(formatFloat(value, decimals)) {}
+    explicit String(double value, unsigned int decimals = 2) : _text(formatFloat(value, decimals)) {}
+
+    unsigned int length() const { return (unsigned int)_text.size(); }
+    const char* c_str() const { return _text.c_str(); }
+    bool reserve(unsigned int size) { _text.reserve(size); return true; }
+
+    bool concat(const String& other) { _text += other._text; return true; }
+    bool concat(const char* text) { if (text) _text += text; return text != nullptr; }
+    bool concat(const char* text, unsigned int length) { _text.append(text, length); return true; }
+    bool concat(char c) { _text += c; return true; }
+    String& operator+=(const String& other) { concat(other); return *this; }
+    String& operator+=(const char* text) { concat(text); return *this; }
+    String& operator+=(char c) { concat(c); return *this; }
+
+    friend String operator+(const String& a, const String& b) { return String(a._text + b._text); }
+    friend String operator+(const String& a, const char* b) { return String(a._text + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b._text); }
+
+    bool equals(const String& other) const { return _text == other._text; }
+    bool equals(const char* text) const { return _text == (text ? text : ""); }
+    bool equalsIgnoreCase(const String& other) const;
+    bool operator==(const String& other) const { return equals(other); }
+    bool operator==(const char* text) const { return equals(text); }
+    bool operator!=(const String& other) const { return !equals(other); }
+    bool operator!=(const char* text) const { return !equals(text); }
+
+    char charAt(unsigned int index) const { return index < _text.size() ? _text[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    int indexOf(char c, unsigned int from = 0) const;
+    int indexOf(const char* text, unsigned int from = 0) const;
+    bool startsWith(const char* prefix) const { return _text.compare(0, strlen(prefix), prefix) == 0; }
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+
+    void trim();
+    void toLowerCase();
+    void toUpperCase();
+    long toInt() const { return atol(_text.c_str()); }
+    float toFloat() const { return (float)atof(_text.c_str()); }
+
+private:
+    std::string _text;
+
+    static std::string formatInteger(long value, unsigned char base);
+    static std::string formatUnsigned(unsigned long value, unsigned char base);
+    static std::string formatFloat(double value, unsigned int decimals);
+};
+
+// ============================================
+// IP ADDRESS
+// ============================================
+
+class IPAddress {
+public:
+    IPAddress() : _address(0) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+        : _address((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+    IPAddress(uint32_t address) : _address(address) {}
+
+    operator uint32_t() const { return _address; }
+    bool operator==(const IPAddress& other) const { return _address == other._address; }
+    bool operator!=(const IPAddress& other) const { return _address != other._address; }
+    uint8_t operator[](int index) const { return (uint8_t)(_address >> (8 * index)); }
+    String toString() const;
+
+private:
+    uint32_t _address;      // First octet in the low byte, as on the boards
+};
+
+// ============================================
+// PRINT / STREAM / CLIENT
+// ============================================
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size);
+    size_t write(const char* text) { return text ? write((const uint8_t*)text, strlen(text)) : 0; }
+    virtual void flush() {}
+
+    size_t print(const char* text) { return write(text); }
+    size_t print(const String& text) { return write((const uint8_t*)text.c_str(), text.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int value, int base = DEC) { return print(String((long)value, (unsigned char)base)); }
+    size_t print(unsigned int value, int base = DEC) { return print(String((unsigned long)value, (unsigned char)base)); }
+    size_t print(long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(double value, int decimals = 2) { return print(String(value, (unsigned int)decimals)); }
+    size_t print(const IPAddress& address) { return print(address.toString()); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& value) { return print(value) + println(); }
+    template <typename T>
+    size_t println(const T& value, int format) { return print(value, format) + println(); }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    void setTimeout(unsigned long timeoutMs) { _timeoutMs = timeoutMs; }
+    size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+
+protected:
+    unsigned long _timeoutMs = 1000;
+    int timedRead();
+};
+
+class Client : public Stream {
+public:
+    virtual int connect(IPAddress ip, uint16_t port) = 0;
+    virtual int connect(const char* host, uint16_t port) = 0;
+    virtual int read(uint8_t* buffer, size_t size) = 0;
+    virtual uint8_t connected() = 0;
+    virtual void stop() = 0;
+    virtual operator bool() = 0;
+    using Stream::read;
+    using Print::write;
+};
+
+// Serial writes to stdout; nothing is ever read
+class HardwareSerial : public Stream {
+public:
+    void begin(unsigned long baud) { (void)baud; }
+    void end() {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    void flush() override;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+// ============================================
+// TIME, PINS, INTERRUPTS
+// ============================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+
+// No interrupt contexts on the host
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+long random(long max);
+long random(long min, long max);
+
+template <typename T>
+T constrain(T value, T low, T high) { return value < low ? low : (value > high ? high : value); }
+
+// RA4M1 port registers (output groups). PCNTR3 writes land here and are not
+// reflected in digitalRead().
+typedef uint16_t bsp_io_port_pin_t;
+typedef struct {
+    volatile uint32_t PCNTR1;
+    volatile uint32_t PCNTR2;
+    volatile uint32_t PCNTR3;
+    volatile uint32_t PCNTR4;
+    uint32_t reserved[4];
+} R_PORT0_Type;
+extern R_PORT0_Type g_inventronixHostPorts[10];
+#define R_PORT0 (&g_inventronixHostPorts[0])
+#define R_PORT1 (&g_inventronixHostPorts[1])
+bsp_io_port_pin_t digitalPinToBspPin(uint8_t pin);   // Port in the high byte
+
+// Wait for an "interrupt": the next 1ms tick
+void __WFI();
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * ArduinoHttpClient shim for the Linux host build
+ *
+ * The HttpClient calls the library makes, over any Client: one HTTP/1.1
+ * request per connection, headers read one at a time, and a body read by
+ * Content-Length (or until the server closes).
+ */
+
+#ifndef INVENTRONIX_HOST_ARDUINO_HTTP_CLIENT_H
+#define INVENTRONIX_HOST_ARDUINO_HTTP_CLIENT_H
+
+#include <Arduino.h>
+
+#define HTTP_ERROR_CONNECTION_FAILED -1
+#define HTTP_ERROR_TIMED_OUT -3
+#define HTTP_ERROR_INVALID_RESPONSE -4
+
+class HttpClient : public Client {
+public:
+    HttpClient(Client& client, const char* host, uint16_t port = 80);
+
+    void beginRequest() {}
+    int startRequest(const char* path, const char* method);
+    int post(const char* path) { return startRequest(path, "POST"); }
+    int post(const String& path) { return post(path.c_str()); }
+    void sendHeader(const char* name, const char* value);
+    void sendHeader(const char* name, const String& value) { sendHeader(name, value.c_str()); }
+    void sendHeader(const char* name, int value) { sendHeader(name, String(value)); }
+    void sendHeader(const char* name, unsigned int value) { sendHeader(name, String(value)); }
+    void sendHeader(const char* name, long value) { sendHeader(name, String(value)); }
+    void sendHeader(const char* name, unsigned long value) { sendHeader(name, String(value)); }
+    void beginBody();
+    void endRequest() { _client.flush(); }
+
+    int responseStatusCode();
+    bool headerAvailable();
+    String readHeaderName() { return _headerName; }
+    String readHeaderValue() { return _headerValue; }
+    int contentLength();
+    int skipResponseHeaders();
+    String responseBody();
+
+    // Client: writes go to the request, reads come from the response body
+    int connect(IPAddress ip, uint16_t port) override { return _client.connect(ip, port); }
+    int connect(const char* host, uint16_t port) override { return _client.connect(host, port); }
+    size_t write(uint8_t c) override { return _client.write(c); }
+    size_t write(const uint8_t* buffer, size_t size) override { return _client.write(buffer, size); }
+    using Print::write;
+    int available() override { return _client.available(); }
+    int read() override;
+    int read(uint8_t* buffer, size_t size) override;
+    int peek() override { return _client.peek(); }
+    uint8_t connected() override { return _client.connected(); }
+    void stop() override { _client.stop(); }
+    operator bool() override { return (bool)_client; }
+
+private:
+    Client& _client;
+    String _host;
+    bool _headersDone;
+    String _headerName;
+    String _headerValue;
+    int _contentLength;         // -1 = not given
+    int _bodyRead;
+
+    bool readLine(String& line);
+};
+
+#endif
@@ -0,0 +1,91 @@
+/**
+ * WiFiS3 shim for the Linux host build
+ *
+ * The "WiFi link" is the host's own network and is always up once begin()
+ * has been called. WiFiClient is a plain TCP socket; WiFiSSLClient is the
+ * same socket without TLS. Every connection goes to INVENTRONIX_HOST_SERVER
+ * (host:port, default 127.0.0.1:8080) whatever host the library asks for,
+ * so requests for api.inventronix.club:443 reach a local test server.
+ */
+
+#ifndef INVENTRONIX_HOST_WIFIS3_H
+#define INVENTRONIX_HOST_WIFIS3_H
+
+#include <Arduino.h>
+
+typedef enum {
+    WL_NO_SHIELD = 255,
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL,
+    WL_SCAN_COMPLETED,
+    WL_CONNECTED,
+    WL_CONNECT_FAILED,
+    WL_CONNECTION_LOST,
+    WL_DISCONNECTED
+} wl_status_t;
+
+class WiFiClass {
+public:
+    int begin(const char* ssid, const char* password = nullptr);
+    void disconnect() { _status = WL_DISCONNECTED; }
+    void end() { _status = WL_IDLE_STATUS; }
+    uint8_t status() { return _status; }
+
+    void config(IPAddress localIp, IPAddress dns, IPAddress gateway, IPAddress subnet);
+    IPAddress localIP() { return _status == WL_CONNECTED ? _localIp : IPAddress(0, 0, 0, 0); }
+    IPAddress gatewayIP() { return _gateway; }
+    IPAddress subnetMask() { return _subnet; }
+    IPAddress dnsIP(int index = 0) { (void)index; return _dns; }
+
+    // Resolves the INVENTRONIX_HOST_SERVER host, where every connection goes
+    int hostByName(const char* host, IPAddress& result);
+
+    const char* SSID() { return _ssid.c_str(); }
+    int32_t RSSI() { return _status == WL_CONNECTED ? -50 : 0; }
+
+    // One network: the SSID last passed to begin()
+    int8_t scanNetworks() { return _ssid.length() > 0 ? 1 : 0; }
+    const char* SSID(uint8_t index) { (void)index; return _ssid.c_str(); }
+    int32_t RSSI(uint8_t index) { (void)index; return -50; }
+
+private:
+    uint8_t _status = WL_IDLE_STATUS;
+    String _ssid;
+    IPAddress _localIp = IPAddress(127, 0, 0, 1);
+    IPAddress _gateway = IPAddress(127, 0, 0, 1);
+    IPAddress _subnet = IPAddress(255, 0, 0, 0);
+    IPAddress _dns = IPAddress(127, 0, 0, 1);
+};
+extern WiFiClass WiFi;
+
+// Blocking TCP socket with a receive timeout
+class WiFiClient : public Client {
+public:
+    WiFiClient() {}
+    ~WiFiClient() override { stop(); }
+
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char* host, uint16_t port) override;
+    size_t write(uint8_t c) override { return write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    int available() override;
+    int read() override;
+    int read(uint8_t* buffer, size_t size) override;
+    int peek() override;
+    uint8_t connected() override;
+    void stop() override;
+    operator bool() override { return _socket >= 0; }
+
+private:
+    int _socket = -1;
+    int _peeked = -1;
+
+    WiFiClient(const WiFiClient&) = delete;
+    WiFiClient& operator=(const WiFiClient&) = delete;
+};
+
+// No TLS on the host: talks plain HTTP to the local server
+class WiFiSSLClient : public WiFiClient {};
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * PwmOut shim for the Linux host build: records the frequency and duty
+ */
+
+#ifndef INVENTRONIX_HOST_PWM_H
+#define INVENTRONIX_HOST_PWM_H
+
+#include <Arduino.h>
+
+class PwmOut {
+public:
+    explicit PwmOut(int pin) : _pin(pin), _frequencyHz(0), _dutyPercent(0), _running(false) {}
+
+    bool begin(float frequencyHz, float dutyPercent) {
+        _frequencyHz = frequencyHz;
+        _dutyPercent = dutyPercent;
+        _running = true;
+        return true;
+    }
+    bool period_us(int us) { _frequencyHz = us > 0 ? 1000000.0f / us : 0; return true; }
+    bool pulse_perc(float dutyPercent) { _dutyPercent = dutyPercent; return true; }
+    void end() { _running = false; }
+
+    int pin() const { return _pin; }
+    float frequencyHz() const { return _frequencyHz; }
+    float dutyPercent() const { return _dutyPercent; }
+
+private:
+    int _pin;
+    float _frequencyHz;
+    float _dutyPercent;
+    bool _running;
+};
+
+#endif
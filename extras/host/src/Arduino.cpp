@@ -0,0 +1,209 @@
+#include <Arduino.h>
+#include <chrono>
+#include <ctype.h>
+#include <stdio.h>
+#include <thread>
+
+HardwareSerial Serial;
+R_PORT0_Type g_inventronixHostPorts[10];
+
+// ============================================
+// STRING
+// ============================================
+
+std::string String::formatInteger(long value, unsigned char base) {
+    if (value < 0 && base == 10) {
+        return "-" + formatUnsigned((unsigned long)(-(value + 1)) + 1, base);
+    }
+    return formatUnsigned((unsigned long)value, base);
+}
+
+std::string String::formatUnsigned(unsigned long value, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    char buffer[8 * sizeof(unsigned long) + 1];
+    char* p = buffer + sizeof(buffer);
+    *--p = '\0';
+    do {
+        int digit = (int)(value % base);
+        *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= base;
+    } while (value > 0);
+    return p;
+}
+
+std::string String::formatFloat(double value, unsigned int decimals) {
+    if (isnan(value)) return "nan";
+    if (isinf(value)) return "inf";
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%.*f", (int)decimals, value);
+    return buffer;
+}
+
+bool String::equalsIgnoreCase(const String& other) const {
+    if (_text.size() != other._text.size()) return false;
+    for (size_t i = 0; i < _text.size(); i++) {
+        if (tolower((unsigned char)_text[i]) != tolower((unsigned char)other._text[i])) return false;
+    }
+    return true;
+}
+
+int String::indexOf(char c, unsigned int from) const {
+    size_t found = _text.find(c, from);
+    return found == std::string::npos ? -1 : (int)found;
+}
+
+int String::indexOf(const char* text, unsigned int from) const {
+    size_t found = _text.find(text, from);
+    return found == std::string::npos ? -1 : (int)found;
+}
+
+String String::substring(unsigned int from) const {
+    return from < _text.size() ? String(_text.substr(from)) : String();
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+        unsigned int swap = from;
+        from = to;
+        to = swap;
+    }
+    return from < _text.size() ? String(_text.substr(from, to - from)) : String();
+}
+
+void String::trim() {
+    size_t start = 0;
+    while (start < _text.size() && isspace((unsigned char)_text[start])) start++;
+    size_t end = _text.size();
+    while (end > start && isspace((unsigned char)_text[end - 1])) end--;
+    _text = _text.substr(start, end - start);
+}
+
+void String::toLowerCase() {
+    for (size_t i = 0; i < _text.size(); i++) _text[i] = (char)tolower((unsigned char)_text[i]);
+}
+
+void String::toUpperCase() {
+    for (size_t i = 0; i < _text.size(); i++) _text[i] = (char)toupper((unsigned char)_text[i]);
+}
+
+String IPAddress::toString() const {
+    char buffer[16];
+    snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(buffer);
+}
+
+// ============================================
+// PRINT / STREAM / SERIAL
+// ============================================
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t written = 0;
+    while (written < size && write(buffer[written])) written++;
+    return written;
+}
+
+int Stream::timedRead() {
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) return c;
+        yield();
+    } while (millis() - start < _timeoutMs);
+    return -1;
+}
+
+size_t Stream::readBytes(char* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = timedRead();
+        if (c < 0) break;
+        buffer[count++] = (char)c;
+    }
+    return count;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return fputc(c, stdout) == EOF ? 0 : 1;
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush() {
+    fflush(stdout);
+}
+
+// ============================================
+// TIME
+// ============================================
+
+static const std::chrono::steady_clock::time_point s_start = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - s_start).count();
+}
+
+unsigned long micros() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - s_start).count();
+}
+
+void delay(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {
+    std::this_thread::yield();
+}
+
+void __WFI() {
+    delay(1);
+}
+
+// ============================================
+// PINS
+// ============================================
+
+#define HOST_PIN_COUNT 32
+
+static uint8_t s_pinLevel[HOST_PIN_COUNT];
+static int s_pinAnalog[HOST_PIN_COUNT];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+    if (pin < HOST_PIN_COUNT && mode == INPUT_PULLUP) s_pinLevel[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin < HOST_PIN_COUNT) s_pinLevel[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < HOST_PIN_COUNT ? s_pinLevel[pin] : LOW;
+}
+
+int analogRead(uint8_t pin) {
+    return pin < HOST_PIN_COUNT ? s_pinAnalog[pin] : 0;
+}
+
+void analogWrite(uint8_t pin, int value) {
+    if (pin < HOST_PIN_COUNT) s_pinAnalog[pin] = value;
+}
+
+// Pin n sits on port n / 16, bit n % 16
+bsp_io_port_pin_t digitalPinToBspPin(uint8_t pin) {
+    return (bsp_io_port_pin_t)(((pin / 16) << 8) | (pin % 16));
+}
+
+long random(long max) {
+    return max > 0 ? rand() % max : 0;
+}
+
+long random(long min, long max) {
+    return max > min ? min + random(max - min) : min;
+}
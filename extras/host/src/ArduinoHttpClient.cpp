@@ -0,0 +1,120 @@
+#include <ArduinoHttpClient.h>
+
+HttpClient::HttpClient(Client& client, const char* host, uint16_t port)
+    : _client(client), _host(host), _headersDone(false), _contentLength(-1), _bodyRead(0) {
+    if (port != 80 && port != 443) {
+        _host += ":";
+        _host += String((unsigned int)port);
+    }
+}
+
+// ============================================
+// REQUEST
+// ============================================
+
+int HttpClient::startRequest(const char* path, const char* method) {
+    _headersDone = false;
+    _contentLength = -1;
+    _bodyRead = 0;
+    _client.print(method);
+    _client.print(" ");
+    _client.print(path);
+    _client.print(" HTTP/1.1\r\n");
+    sendHeader("Host", _host.c_str());
+    sendHeader("Connection", "close");
+    return 0;
+}
+
+void HttpClient::sendHeader(const char* name, const char* value) {
+    _client.print(name);
+    _client.print(": ");
+    _client.print(value);
+    _client.print("\r\n");
+}
+
+void HttpClient::beginBody() {
+    _client.print("\r\n");
+}
+
+// ============================================
+// RESPONSE
+// ============================================
+
+// One CRLF-terminated line, without the terminator
+bool HttpClient::readLine(String& line) {
+    line = "";
+    _client.setTimeout(_timeoutMs);
+    for (;;) {
+        char c;
+        if (_client.readBytes(&c, 1) != 1) return false;
+        if (c == '\n') return true;
+        if (c != '\r') line += c;
+    }
+}
+
+int HttpClient::responseStatusCode() {
+    String line;
+    if (!readLine(line)) return HTTP_ERROR_TIMED_OUT;
+    if (!line.startsWith("HTTP/")) return HTTP_ERROR_INVALID_RESPONSE;
+    int space = line.indexOf(' ');
+    if (space < 0) return HTTP_ERROR_INVALID_RESPONSE;
+    return (int)line.substring(space + 1).toInt();
+}
+
+bool HttpClient::headerAvailable() {
+    if (_headersDone) return false;
+    String line;
+    if (!readLine(line) || line.length() == 0) {
+        _headersDone = true;
+        return false;
+    }
+    int colon = line.indexOf(':');
+    _headerName = colon < 0 ? line : line.substring(0, colon);
+    _headerValue = colon < 0 ? String() : line.substring(colon + 1);
+    _headerValue.trim();
+    if (_headerName.equalsIgnoreCase("Content-Length")) {
+        _contentLength = (int)_headerValue.toInt();
+    }
+    return true;
+}
+
+int HttpClient::skipResponseHeaders() {
+    while (headerAvailable()) {}
+    return 0;
+}
+
+// Known once the headers are read, so any unread ones are skipped
+int HttpClient::contentLength() {
+    skipResponseHeaders();
+    return _contentLength;
+}
+
+String HttpClient::responseBody() {
+    skipResponseHeaders();
+    String body;
+    if (_contentLength > 0) body.reserve((unsigned int)_contentLength);
+    uint8_t buffer[512];
+    while (_contentLength < 0 || _bodyRead < _contentLength) {
+        int n = read(buffer, sizeof(buffer));
+        if (n <= 0) break;
+        body.concat((const char*)buffer, (unsigned int)n);
+    }
+    return body;
+}
+
+int HttpClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int HttpClient::read(uint8_t* buffer, size_t size) {
+    if (_contentLength >= 0) {
+        if (_bodyRead >= _contentLength) return -1;
+        size_t left = (size_t)(_contentLength - _bodyRead);
+        if (size > left) size = left;
+    }
+    _client.setTimeout(_timeoutMs);
+    int n = _client.read(buffer, size);
+    if (n > 0) _bodyRead += n;
+    return n;
+}
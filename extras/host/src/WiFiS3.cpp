@@ -0,0 +1,176 @@
+#include <WiFiS3.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define HOST_SERVER_DEFAULT "127.0.0.1:8080"
+#define HOST_CONNECT_TIMEOUT_MS 5000
+
+WiFiClass WiFi;
+
+// ============================================
+// WIFI
+// ============================================
+
+int WiFiClass::begin(const char* ssid, const char* password) {
+    (void)password;
+    _ssid = ssid ? ssid : "";
+    _status = WL_CONNECTED;
+    return _status;
+}
+
+void WiFiClass::config(IPAddress localIp, IPAddress dns, IPAddress gateway, IPAddress subnet) {
+    // All-zero means "back to DHCP", which on the host is loopback
+    _localIp = (uint32_t)localIp ? localIp : IPAddress(127, 0, 0, 1);
+    _dns = dns;
+    _gateway = gateway;
+    _subnet = subnet;
+}
+
+// ============================================
+// CLIENT
+// ============================================
+
+// INVENTRONIX_HOST_SERVER, split into host and port
+static void hostServer(String& host, String& port) {
+    const char* server = getenv("INVENTRONIX_HOST_SERVER");
+    String text = (server && *server) ? server : HOST_SERVER_DEFAULT;
+    int colon = text.indexOf(':');
+    if (colon < 0) {
+        host = text;
+        port = "80";
+    } else {
+        host = text.substring(0, colon);
+        port = text.substring(colon + 1);
+    }
+}
+
+int WiFiClass::hostByName(const char* host, IPAddress& result) {
+    (void)host;
+    String serverHost, serverPort;
+    hostServer(serverHost, serverPort);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    struct addrinfo* addresses = nullptr;
+    if (getaddrinfo(serverHost.c_str(), nullptr, &hints, &addresses) != 0 || !addresses) {
+        return 0;
+    }
+    result = IPAddress((uint32_t)((struct sockaddr_in*)addresses->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(addresses);
+    return 1;
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    (void)ip;
+    return connect("", port);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    (void)host;
+    (void)port;
+    stop();
+
+    String serverHost, serverPort;
+    hostServer(serverHost, serverPort);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* addresses = nullptr;
+    if (getaddrinfo(serverHost.c_str(), serverPort.c_str(), &hints, &addresses) != 0) {
+        return 0;
+    }
+
+    for (struct addrinfo* a = addresses; a && _socket < 0; a = a->ai_next) {
+        int fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd < 0) continue;
+        struct timeval timeout = { HOST_CONNECT_TIMEOUT_MS / 1000, 0 };
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        if (::connect(fd, a->ai_addr, a->ai_addrlen) == 0) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            _socket = fd;
+        } else {
+            close(fd);
+        }
+    }
+    freeaddrinfo(addresses);
+    return _socket >= 0 ? 1 : 0;
+}
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+    size_t sent = 0;
+    while (_socket >= 0 && sent < size) {
+        ssize_t n = send(_socket, buffer + sent, size - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) continue;
+            break;
+        }
+        sent += (size_t)n;
+    }
+    return sent;
+}
+
+int WiFiClient::available() {
+    if (_socket < 0) return 0;
+    int queued = 0;
+    struct pollfd pfd = { _socket, POLLIN, 0 };
+    if (poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN)) {
+        uint8_t probe[1024];
+        ssize_t n = recv(_socket, probe, sizeof(probe), MSG_PEEK);
+        queued = n > 0 ? (int)n : 0;
+    }
+    return queued + (_peeked >= 0 ? 1 : 0);
+}
+
+int WiFiClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+// Waits up to the stream timeout for the first byte, then takes what is there
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+    if (size == 0 || (_socket < 0 && _peeked < 0)) return -1;
+    size_t count = 0;
+    if (_peeked >= 0) {
+        buffer[count++] = (uint8_t)_peeked;
+        _peeked = -1;
+        if (count == size) return (int)count;
+    }
+    if (_socket < 0) return (int)count;
+
+    struct pollfd pfd = { _socket, POLLIN, 0 };
+    if (count == 0 && poll(&pfd, 1, (int)_timeoutMs) <= 0) return -1;
+    ssize_t n = recv(_socket, buffer + count, size - count, count > 0 ? MSG_DONTWAIT : 0);
+    if (n > 0) count += (size_t)n;
+    return count > 0 ? (int)count : -1;
+}
+
+int WiFiClient::peek() {
+    if (_peeked < 0) _peeked = read();
+    return _peeked;
+}
+
+uint8_t WiFiClient::connected() {
+    if (_peeked >= 0) return 1;
+    if (_socket < 0) return 0;
+    uint8_t probe;
+    ssize_t n = recv(_socket, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    return (n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))) ? 1 : 0;
+}
+
+void WiFiClient::stop() {
+    if (_socket >= 0) {
+        close(_socket);
+        _socket = -1;
+    }
+    _peeked = -1;
+}
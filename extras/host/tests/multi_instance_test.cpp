@@ -0,0 +1,274 @@
+/**
+ * Two Inventronix instances in one process (host test)
+ *
+ * The host-side counterpart of the self-check in examples/MultiInstance:
+ * both instances register the same command names, then
+ * - pulses are triggered interleaved across the two, and each must run its
+ *   own instance's callbacks, for its own duration, on its own pin
+ * - each instance sends to a mock ingest server in this process, which
+ *   answers with commands for that project only, and every command must be
+ *   dispatched to the instance that sent the request
+ *
+ * Build and run from the repository root:
+ *   cmake -S . -B build && cmake --build build
+ *   ctest --test-dir build --output-on-failure
+ *
+ * Exits non-zero if any check fails.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <Inventronix.h>
+
+#define PROJECT_A_ID "proj_a"
+#define PROJECT_B_ID "proj_b"
+
+#define VALVE_A_PIN 4
+#define VALVE_B_PIN 5
+
+// ============================================
+// MOCK INGEST SERVER
+// ============================================
+
+static std::atomic<unsigned long> s_requests(0);
+
+// Commands for whichever project sent the request. Both projects reuse the
+// same execution_id, so a dedup cache shared between instances would show up.
+static std::string mockResponse(const std::string& request) {
+    bool projectA = strcasestr(request.c_str(), "\r\nX-Project-Id: " PROJECT_A_ID "\r\n") != nullptr;
+    std::string id = std::to_string(++s_requests);
+    return std::string("{\"commands\":[") +
+           "{\"command\":\"status_led\",\"execution_id\":\"led-" + id + "\",\"arguments\":{\"on\":" +
+           (projectA ? "true" : "false") + "}}," +
+           "{\"command\":\"dose\",\"execution_id\":\"dose-" + id + "\",\"arguments\":{\"duration\":" +
+           (projectA ? "200" : "80") + "}}]}";
+}
+
+// Read one request (headers, then Content-Length bytes of body)
+static bool readRequest(int fd, std::string& data) {
+    char buffer[4096];
+    size_t headerEnd = std::string::npos;
+    long contentLength = 0;
+    for (;;) {
+        if (headerEnd == std::string::npos) {
+            headerEnd = data.find("\r\n\r\n");
+            if (headerEnd != std::string::npos) {
+                const char* field = strcasestr(data.c_str(), "\r\nContent-Length:");
+                if (field && field < data.c_str() + headerEnd) {
+                    contentLength = atol(field + 17);
+                }
+            }
+        }
+        if (headerEnd != std::string::npos && data.size() >= headerEnd + 4 + (size_t)contentLength) {
+            return true;
+        }
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            return false;
+        }
+        data.append(buffer, (size_t)n);
+    }
+}
+
+static void serveMock(int listener) {
+    for (;;) {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        std::string request;
+        if (readRequest(fd, request)) {
+            std::string body = mockResponse(request);
+            std::string response =
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Type: application/json\r\n"
+                "Connection: close\r\n"
+                "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+            send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+        }
+        close(fd);
+    }
+}
+
+// Listen on an ephemeral loopback port and point the host shim at it
+static bool startMock() {
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    if (listener < 0 || bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        listen(listener, 16) != 0 || getsockname(listener, (struct sockaddr*)&address, &length) != 0) {
+        perror("mock server");
+        return false;
+    }
+    std::string server = "127.0.0.1:" + std::to_string(ntohs(address.sin_port));
+    setenv("INVENTRONIX_HOST_SERVER", server.c_str(), 1);
+    std::thread(serveMock, listener).detach();
+    return true;
+}
+
+// ============================================
+// TEST
+// ============================================
+
+Inventronix clientA;
+Inventronix clientB;
+
+// What each instance's callbacks have seen
+struct Tally {
+    int pulseOn;
+    int pulseOff;
+    unsigned long lastOnMs;
+    unsigned long lastWidthMs;
+    int ledCommands;
+    bool ledOn;
+};
+Tally tallyA;
+Tally tallyB;
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    Serial.print(ok ? "  PASS  " : "  FAIL  ");
+    Serial.println(what);
+    if (!ok) failures++;
+}
+
+static bool widthNear(unsigned long width, unsigned long expected) {
+    return width + 5 >= expected && width <= expected + 40;
+}
+
+// Register the same command names on one instance, wired to its own tally
+static void registerCommands(Inventronix& client, Tally& tally, int valvePin) {
+    client.onPulse("dose", 0,
+        [&tally]() {
+            tally.pulseOn++;
+            tally.lastOnMs = millis();
+        },
+        [&tally]() {
+            tally.pulseOff++;
+            tally.lastWidthMs = millis() - tally.lastOnMs;
+        });
+
+    client.onPulse("valve", valvePin, 2000);
+
+    client.onCommand("status_led", [&tally](JsonObject args) {
+        tally.ledCommands++;
+        tally.ledOn = args["on"] | false;
+    });
+}
+
+// Run both instances' loops until `ms` has passed
+static void runBoth(unsigned long ms) {
+    unsigned long start = millis();
+    while (millis() - start < ms) {
+        clientA.loop();
+        clientB.loop();
+        delay(1);
+    }
+}
+
+static void checkInterleavedPulses() {
+    Serial.println("Interleaved pulses on two instances");
+
+    // A: 300ms, then B: 100ms while A is still on
+    check(clientA.triggerPulse("dose", 300), "A dose starts");
+    runBoth(50);
+    check(clientB.triggerPulse("dose", 100), "B dose starts while A is pulsing");
+    check(clientA.isPulsing("dose") && clientB.isPulsing("dose"), "both pulsing");
+    check(tallyA.pulseOn == 1 && tallyB.pulseOn == 1, "each on callback ran once, on its own instance");
+
+    // B ends first; A must keep going
+    runBoth(150);
+    check(!clientB.isPulsing("dose"), "B ended after its own duration");
+    check(clientA.isPulsing("dose"), "A still pulsing");
+    check(tallyB.pulseOff == 1 && tallyA.pulseOff == 0, "only B's off callback ran");
+
+    // A repeat on B does not touch A (A ignores repeats by default)
+    check(clientB.triggerPulse("dose", 100), "B dose restarts");
+    check(!clientA.triggerPulse("dose", 100), "A repeat is ignored while A is pulsing");
+
+    runBoth(250);
+    check(!clientA.isPulsing("dose") && !clientB.isPulsing("dose"), "both ended");
+    check(tallyA.pulseOff == 1 && tallyB.pulseOff == 2, "off callbacks matched their instances");
+    check(widthNear(tallyA.lastWidthMs, 300), "A width ~300ms");
+    check(widthNear(tallyB.lastWidthMs, 100), "B width ~100ms");
+
+    // Pin pulses on the same name drive different pins
+    clientA.triggerPulse("valve", 100);
+    runBoth(20);
+    check(digitalRead(VALVE_A_PIN) == HIGH && digitalRead(VALVE_B_PIN) == LOW, "A valve pin only");
+    runBoth(120);
+    check(digitalRead(VALVE_A_PIN) == LOW, "A valve pin off");
+}
+
+static void checkCommandDispatch() {
+    Serial.println("Server commands reach the instance that sent the request");
+
+    // A's response: status_led on, dose 200ms
+    Inventronix::Payload& payloadA = clientA.beginPayload();
+    payloadA.add("client", "A");
+    check(clientA.sendPayload(payloadA), "A send");
+    check(tallyA.ledCommands == 1 && tallyA.ledOn, "A handled its status_led");
+    check(tallyB.ledCommands == 0, "B saw nothing");
+    check(clientA.isPulsing("dose") && !clientB.isPulsing("dose"), "only A's dose started");
+
+    // B's response reuses A's execution_ids: status_led off, dose 80ms
+    s_requests = 0;
+    Inventronix::Payload& payloadB = clientB.beginPayload();
+    payloadB.add("client", "B");
+    check(clientB.sendPayload(payloadB), "B send");
+    check(tallyB.ledCommands == 1 && !tallyB.ledOn, "B handled its status_led");
+    check(tallyA.ledCommands == 1 && tallyA.ledOn, "A untouched");
+    check(clientB.isPulsing("dose"), "B's dose started despite A having the same execution_id");
+
+    runBoth(300);
+    check(tallyA.pulseOff == 2 && tallyB.pulseOff == 3, "both server doses ended");
+    check(widthNear(tallyA.lastWidthMs, 200), "A server dose ~200ms");
+    check(widthNear(tallyB.lastWidthMs, 80), "B server dose ~80ms");
+}
+
+int main() {
+    if (!startMock()) {
+        return 1;
+    }
+
+    clientA.setVerboseLogging(false);
+    clientB.setVerboseLogging(false);
+    clientA.begin(PROJECT_A_ID, "key_a");
+    clientB.begin(PROJECT_B_ID, "key_b");
+    clientA.setRetryAttempts(1);
+    clientB.setRetryAttempts(1);
+    registerCommands(clientA, tallyA, VALVE_A_PIN);
+    registerCommands(clientB, tallyB, VALVE_B_PIN);
+
+    checkInterleavedPulses();
+
+    // One WiFi link serves both clients
+    if (!clientA.connectWiFi("host", "")) {
+        Serial.println("WiFi shim did not come up");
+        return 1;
+    }
+    checkCommandDispatch();
+
+    Serial.print(failures == 0 ? "All checks passed" : "FAILED: ");
+    if (failures > 0) Serial.print(failures);
+    Serial.println();
+    Serial.flush();
+    return failures == 0 ? 0 : 1;
+}
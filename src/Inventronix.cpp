@@ -1,47 +1,180 @@
 #include <Arduino.h>
+#include <new>
 #include "Inventronix.h"
 
 #ifdef INVENTRONIX_PLATFORM_ESP
-// Static instance pointer for Ticker callbacks
-Inventronix* Inventronix::_instance = nullptr;
+#include <soc/soc.h>
+#include <soc/gpio_reg.h>
+#include <esp_sleep.h>
+#include <time.h>
+#endif
 
-// Static callback for Ticker (workaround for no lambda capture support)
-void Inventronix::pulseOffCallback(int pulseIndex) {
-    if (_instance != nullptr) {
-        _instance->handlePulseOff(pulseIndex);
-    }
-}
+#ifndef RTC_DATA_ATTR
+#define RTC_DATA_ATTR
+#endif
+
+// Dispatch index values: slot number, with the top two bits marking the handler kind
+static const uint16_t DISPATCH_KIND_MASK = 0xC000;
+static const uint16_t DISPATCH_PULSE_FLAG = 0x8000;
+static const uint16_t DISPATCH_PWM_FLAG = 0x4000;
+static const uint16_t DISPATCH_GROUP_FLAG = 0xC000;
+static const uint16_t DISPATCH_INDEX_MASK = 0x3FFF;
+
+// PwmHandler::repeatsLeft value for a step list that runs until replaced
+static const uint16_t PWM_REPEAT_FOREVER = 0xFFFF;
+
+// The pulse queues are shared with the esp_timer task on ESP and with the
+// precision timer interrupt on R4
+#ifdef INVENTRONIX_PLATFORM_ESP
+#define PULSE_LOCK()   portENTER_CRITICAL(&_pulseLock)
+#define PULSE_UNLOCK() portEXIT_CRITICAL(&_pulseLock)
+#else
+#define PULSE_LOCK()   noInterrupts()
+#define PULSE_UNLOCK() interrupts()
+#endif
+
+#ifdef INVENTRONIX_PRECISION_RMT
+// RMT ticks at 1MHz; each symbol holds two levels of up to 32767 ticks
+static const uint32_t RMT_RESOLUTION_HZ = 1000000;
+static const uint32_t RMT_MAX_HALF_US = 32767;
+#endif
+
+#if defined(INVENTRONIX_PLATFORM_ESP) && !defined(INVENTRONIX_LEDC_PIN_API)
+// LEDC channels are a chip resource shared by every Inventronix instance.
+// Even channels only: each pair shares a timer, and every PWM command needs
+// its own frequency.
+static uint8_t s_nextLedcChannel = 0;
 #endif
 
 // Constructor
-Inventronix::Inventronix() {
+Inventronix::Inventronix() : _payload(_txBuffer, sizeof(_txBuffer)) {
     _retryAttempts = INVENTRONIX_DEFAULT_RETRY_ATTEMPTS;
     _retryDelay = INVENTRONIX_DEFAULT_RETRY_DELAY;
     _verboseLogging = INVENTRONIX_VERBOSE_LOGGING;
     _debugMode = false;
+    _transport = nullptr;
     _commandCount = 0;
+    _pulses = nullptr;
     _pulseCount = 0;
+    _pwmCount = 0;
+    _groupCount = 0;
+    _pulseCapacity = 0;
+#ifdef INVENTRONIX_PLATFORM_ESP
+    _pulseTimer = nullptr;
+    _idleTask = nullptr;
+    portMUX_INITIALIZE(&_pulseLock);
+#endif
+#ifdef INVENTRONIX_PRECISION_GPT
+    _precisionTicksPerUs = 0;
+    _precisionTimerReady = false;
+#endif
+    _wifiNetworkCount = 0;
+    _wifiNetwork = 0;
+    _wifiCandidateCount = 0;
+    _wifiNextCandidate = 0;
     _wifiManaged = false;
+#ifdef INVENTRONIX_PLATFORM_ESP
+    _roamThresholdDbm = INVENTRONIX_WIFI_ROAM_RSSI;
+#else
+    _roamThresholdDbm = 0;     // A roam scan stalls loop() on UNO R4 - opt in with setWiFiRoaming()
+#endif
+    _roamHoldMs = INVENTRONIX_WIFI_ROAM_HOLD_MS;
+    _wifiRssi = 0;
+    _wifiRssiAt = 0;
+    _wifiWeakSince = 0;
+    _wifiWeak = false;
+    _wifiRoamScan = false;
+    _roamScanAt = 0;
+    _wifiRoams = 0;
+    _wifiState = WIFI_LINK_OFF;
+    _wifiAttemptAt = 0;
+    _wifiRetryAt = 0;
+    _wifiBackoffMs = INVENTRONIX_WIFI_RETRY_MIN_MS;
+    _wifiFastAttempt = false;
+    _staticIpSet = false;
+#ifdef INVENTRONIX_PLATFORM_ESP
+    _wifiAddressFixed = false;
+    _wifiRadio = 0;
+    _wifiEventId = 0;
+    _wifiEventsAttached = false;
+#else
+    _wifiPolledAt = 0;
+#endif
+    _ackHead = 0;
+    _ackCount = 0;
+    _acksDropped = 0;
+    _commandAcks = false;
+    _ackScratch = nullptr;
+    _ackScratchSize = 0;
+    _resultSuccess = true;
+    _resultValue = nullptr;
+    _queueHead = 0;
+    _queueCount = 0;
+    _queueOverflows = 0;
+    _deferredCommands = false;
+    _commandBudgetUs = INVENTRONIX_DEFAULT_COMMAND_BUDGET_US;
+    _serverEpochAtSync = 0;
+    _millisAtSync = 0;
+    _clockSynced = false;
+    _recentNext = 0;
+    _recentCount = 0;
+    _dedupTtl = INVENTRONIX_DEFAULT_DEDUP_TTL;
+    _duplicatesSuppressed = 0;
+    _parseDepth = 0;
 
     // Initialize command registry
     for (int i = 0; i < INVENTRONIX_MAX_COMMANDS; i++) {
         _commands[i].registered = false;
     }
-    for (int i = 0; i < INVENTRONIX_MAX_PULSES; i++) {
-        _pulses[i].registered = false;
-        _pulses[i].active = false;
+    for (int i = 0; i < INVENTRONIX_MAX_PWM; i++) {
+        _pwm[i].registered = false;
+    }
+    for (int i = 0; i < INVENTRONIX_MAX_OUTPUT_GROUPS; i++) {
+        _groups[i].registered = false;
+    }
+}
+
+// Destructor
+Inventronix::~Inventronix() {
+#ifdef INVENTRONIX_PLATFORM_ESP
+    if (_wifiEventsAttached) {
+        WiFi.removeEvent(_wifiEventId);
+    }
+    if (_pulseTimer != nullptr) {
+        esp_timer_stop(_pulseTimer);
+        esp_timer_delete(_pulseTimer);
+    }
+#endif
+#ifdef INVENTRONIX_PRECISION_GPT
+    if (_precisionTimerReady) {
+        _precisionTimer.stop();
+    }
+#endif
+#ifdef INVENTRONIX_PLATFORM_RENESAS
+    for (int i = 0; i < _pwmCount; i++) {
+        delete _pwm[i].output;
+    }
+#endif
+    for (int i = 0; i < _pulseCount; i++) {
+#ifdef INVENTRONIX_PRECISION_RMT
+        free(_pulses[i]->symbols);
+#endif
+        free(_pulses[i]->followOns);
+        delete _pulses[i];
     }
+    free(_pulses);
+    free(_ackScratch);
 }
 
 // Initialize the library
-void Inventronix::begin(const char* projectId, const char* apiKey) {
+void Inventronix::begin(const char* projectId, const char* apiKey, size_t parseArenaSize) {
     _projectId = String(projectId);  // Convert C-string to Arduino String
     _apiKey = String(apiKey);
 
-#ifdef INVENTRONIX_PLATFORM_ESP
-    // Store instance pointer for static Ticker callbacks
-    _instance = this;
-#endif
+    // Reserve the command parsing pool once, up front
+    if (!_parseArena.begin(parseArenaSize) && _verboseLogging) {
+        Serial.println("⚠️  Could not allocate parse arena, commands will be ignored");
+    }
 
     if (_verboseLogging) {
         Serial.println("Inventronix initialized");
@@ -75,17 +208,102 @@ void Inventronix::setDebugMode(bool enabled) {
     _debugMode = enabled;
 }
 
-// Core HTTP POST with retry logic
+// Enable/disable piggybacking command acks on ingest requests
+void Inventronix::setCommandAcks(bool enabled) {
+    _commandAcks = enabled;
+}
+
+// Route requests through a caller-owned transport (nullptr = built-in)
+void Inventronix::setTransport(InventronixTransport* transport) {
+    _transport = transport;
+}
+
+// Queue commands for loop() instead of running them inside sendPayload()
+void Inventronix::setDeferredCommands(bool enabled, unsigned long budgetUs) {
+    _deferredCommands = enabled;
+    _commandBudgetUs = budgetUs;
+}
+
+// Commands waiting for loop()
+int Inventronix::queuedCommandCount() const {
+    return _queueCount;
+}
+
+// Commands rejected because the queue (or a slot) was full
+unsigned long Inventronix::commandQueueOverflows() const {
+    return _queueOverflows;
+}
+
+// How long an execution_id is remembered (0 = until pushed out of the cache)
+void Inventronix::setDedupTtl(unsigned long milliseconds) {
+    _dedupTtl = milliseconds;
+}
+
+// Replayed commands that were not run again
+unsigned long Inventronix::duplicateCommandsSuppressed() const {
+    return _duplicatesSuppressed;
+}
+
+// Total size of the command parsing pool
+size_t Inventronix::parseArenaSize() const {
+    return _parseArena.size();
+}
+
+// Largest number of parse pool bytes used by any response so far
+size_t Inventronix::parseArenaHighWater() const {
+    return _parseArena.highWater();
+}
+
+// Reset and return the builder for the library-owned transmit buffer
+Inventronix::Payload& Inventronix::beginPayload() {
+    return _payload.clear();
+}
+
+// Send a payload built with beginPayload() (or any Payload)
+bool Inventronix::sendPayload(const Payload& payload) {
+    if (payload.overflowed()) {
+        if (_verboseLogging) {
+            Serial.print("❌ Payload too large for its buffer (");
+            Serial.print(payload.capacity());
+            Serial.println(" bytes), not sending");
+        }
+        return false;
+    }
+    return sendPayload(payload.c_str());
+}
+
+// Send a pre-serialised template - values were patched in place by set()
+bool Inventronix::sendPayload(const PayloadTemplate& payloadTemplate) {
+    if (payloadTemplate.overflowed()) {
+        if (_verboseLogging) {
+            Serial.println("❌ Payload template is missing fields (too many or too long), not sending");
+        }
+        return false;
+    }
+    return sendPayload(payloadTemplate.c_str());
+}
+
+// Send a JSON payload (commands in the response are dispatched)
 bool Inventronix::sendPayload(const char* jsonPayload) {
     // Ensure WiFi is connected (auto-reconnect if needed)
     if (!ensureWiFi()) {
         return false;
     }
 
+    // Piggyback pending command acks on this request
+    int acksAttached = 0;
+    char* ackStart = nullptr;
+    const char* body = attachAcks(jsonPayload, acksAttached, ackStart);
+    return postIngest(body, acksAttached, ackStart);
+}
+
+// Core HTTP POST with retry logic. `body` already carries `acksAttached`
+// acks, starting at `ackStart` (nullptr if none were appended).
+bool Inventronix::postIngest(const char* body, int acksAttached, char* ackStart) {
     // Retry loop with exponential backoff
     for (int attempt = 1; attempt <= _retryAttempts; attempt++) {
         String responseBody;
-        int statusCode = sendHTTPRequest(jsonPayload, responseBody);
+        int statusCode = sendHTTPRequest(body, responseBody);
 
         // Log the response details
         if (_verboseLogging && statusCode > 0) {
@@ -105,6 +323,8 @@ bool Inventronix::sendPayload(const char* jsonPayload) {
         // Success! (any 2xx status code)
         if (statusCode >= 200 && statusCode < 300) {
             logSuccess();
+            detachAcks(ackStart);
+            releaseAcks(acksAttached);
             processCommands(responseBody);
             return true;
         }
@@ -112,6 +332,11 @@ bool Inventronix::sendPayload(const char* jsonPayload) {
         // Don't retry on client errors (except 429 rate limit)
         if (statusCode >= 400 && statusCode < 500 && statusCode != 429) {
             logError(statusCode, responseBody);
+            detachAcks(ackStart);
+            bool acksSuspect = statusCode == 400 || statusCode == 413 || statusCode == 422;
+            if (acksSuspect && acksAttached > 0 && ackStart != nullptr) {
+                return retryWithoutAcks(body, acksAttached);
+            }
             return false;
         }
 
@@ -138,103 +363,256 @@ bool Inventronix::sendPayload(const char* jsonPayload) {
     if (_verboseLogging) {
         Serial.println("❌ Max retry attempts reached. Giving up.");
     }
+    detachAcks(ackStart);
     return false;
 }
 
-// Actual HTTP POST - platform-specific implementations
-int Inventronix::sendHTTPRequest(const char* jsonPayload, String& responseBody) {
-    String url = buildURL();
+// A 400/413/422 on a request carrying acks may be the "_acks" key (unknown
+// to the endpoint, or too large) rather than the payload. Send the bare
+// payload (acks already detached) once: if it goes through, the acks were
+// the problem - drop the `acksAttached` that went out with it. Acks stay on,
+// so later commands are still acknowledged.
+bool Inventronix::retryWithoutAcks(const char* body, int acksAttached) {
+    unsigned long droppedBefore = _acksDropped;
+    if (!postIngest(body, 0, nullptr)) {
+        return false;   // The payload itself was rejected - acks wait
+    }
 
-    if (_debugMode) {
-        logDebug("POST " + url);
-        logDebug("Payload: " + String(jsonPayload));
+    // Acks queued by this response may have pushed some of ours out already
+    int overwritten = (int)(_acksDropped - droppedBefore);
+    int stale = acksAttached > overwritten ? acksAttached - overwritten : 0;
+    _acksDropped += stale;
+    releaseAcks(stale);
+    if (_verboseLogging) {
+        Serial.print("⚠️  Server rejected command acks - dropped ");
+        Serial.print(stale);
+        Serial.println(" ack(s)");
     }
+    return true;
+}
 
-#ifdef INVENTRONIX_PLATFORM_ESP
-    // ESP32/ESP8266 implementation using HTTPClient
-    HTTPClient http;
-    WiFiClientSecure client;
+// ============================================
+// COMMAND ACKNOWLEDGEMENTS
+// ============================================
 
-    // Skip SSL certificate verification (for simplicity)
-    client.setInsecure();
+// Report the outcome of the command handler that is currently running
+void Inventronix::setCommandResult(bool success, const char* result) {
+    _resultSuccess = success;
+    _resultValue = result;
+}
 
-    http.begin(client, url);
-    http.setTimeout(INVENTRONIX_HTTP_TIMEOUT);
+// Number of acks waiting to go out with the next request
+int Inventronix::pendingAckCount() const {
+    return _ackCount;
+}
 
-    // Set headers
-    http.addHeader("Content-Type", "application/json");
-    http.addHeader("X-Api-Key", _apiKey);
-    http.addHeader("X-Project-Id", _projectId);
-    http.addHeader("User-Agent", INVENTRONIX_USER_AGENT);
+// Number of acks overwritten because the buffer was full
+unsigned long Inventronix::droppedAckCount() const {
+    return _acksDropped;
+}
 
-    // Send POST request
-    int statusCode = http.POST(jsonPayload);
+// Record an execution result for the next ingest request
+void Inventronix::queueAck(const char* executionId, bool success, const char* result) {
+    if (!_commandAcks || executionId == nullptr || executionId[0] == '\0') return;
 
-    // Get response body
-    if (statusCode > 0) {
-        responseBody = http.getString();
+    // Full: drop the oldest so the most recent outcomes survive
+    if (_ackCount == INVENTRONIX_ACK_BUFFER_SIZE) {
+        _ackHead = (_ackHead + 1) % INVENTRONIX_ACK_BUFFER_SIZE;
+        _ackCount--;
+        _acksDropped++;
+        if (_verboseLogging) {
+            Serial.println("⚠️  Ack buffer full, dropping oldest ack");
+        }
     }
 
-    http.end();
+    CommandAck& ack = _acks[(_ackHead + _ackCount) % INVENTRONIX_ACK_BUFFER_SIZE];
+    strncpy(ack.executionId, executionId, sizeof(ack.executionId) - 1);
+    ack.executionId[sizeof(ack.executionId) - 1] = '\0';
+    ack.result[0] = '\0';
+    if (result != nullptr) {
+        strncpy(ack.result, result, sizeof(ack.result) - 1);
+        ack.result[sizeof(ack.result) - 1] = '\0';
+    }
+    ack.success = success;
+    _ackCount++;
+}
 
-#else
-    // Arduino UNO R4 WiFi / Renesas implementation using ArduinoHttpClient
-    // R4's WiFiSSLClient has known issues - must use class member, not local variable
-    const char* host = "api.inventronix.club";
-    String path = String(INVENTRONIX_INGEST_ENDPOINT);
-    if (_schemaId.length() > 0) {
-        path += "?schema_id=" + _schemaId;
+// Append pending acks to the payload object as "_acks":[...]. A payload in
+// the transmit buffer is extended in place; any other payload is copied to a
+// scratch body first (grown as needed and kept for the next send), so a
+// half-built beginPayload() is never touched. Returns the body to send;
+// `attached` is how many acks made it in, and `ackStart` is where they begin.
+const char* Inventronix::attachAcks(const char* jsonPayload, int& attached, char*& ackStart) {
+    attached = 0;
+    ackStart = nullptr;
+    if (!_commandAcks || _ackCount == 0) return jsonPayload;
+
+    // Payload must be a JSON object we can re-open
+    size_t length = strlen(jsonPayload);
+    while (length > 0 && (jsonPayload[length - 1] == ' ' || jsonPayload[length - 1] == '\n' ||
+                          jsonPayload[length - 1] == '\r' || jsonPayload[length - 1] == '\t')) {
+        length--;
+    }
+    if (length < 2 || jsonPayload[length - 1] != '}') return jsonPayload;
+
+    // Room for the header, the closing "]}" and the terminator
+    static const char ACK_KEY[] = "\"" INVENTRONIX_ACK_FIELD "\":[";
+    char* body = _txBuffer;
+    size_t capacity = sizeof(_txBuffer);
+    if (jsonPayload != _txBuffer) {
+        capacity = length + sizeof(ACK_KEY) + 3 +
+                   (size_t)_ackCount * (INVENTRONIX_EXECUTION_ID_LENGTH + INVENTRONIX_ACK_RESULT_LENGTH + 64);
+        if (capacity > _ackScratchSize) {
+            char* grown = (char*)realloc(_ackScratch, capacity);
+            if (grown == nullptr) return jsonPayload;  // No memory - acks wait
+            _ackScratch = grown;
+            _ackScratchSize = capacity;
+        }
+        body = _ackScratch;
+        memcpy(body, jsonPayload, length);
+    }
+
+    size_t close = length - 1;
+    size_t pos = close;
+    bool emptyObject = true;
+    for (size_t i = 1; i < close; i++) {
+        if (body[i] != ' ' && body[i] != '\n' && body[i] != '\r' && body[i] != '\t') {
+            emptyObject = false;
+            break;
+        }
     }
 
-    // Drain any residual data and reset the client properly
-    while (_sslClient.available()) {
-        _sslClient.read();
+    size_t headerLength = (emptyObject ? 0 : 1) + sizeof(ACK_KEY) - 1;
+    if (pos + headerLength + 3 <= capacity) {
+        if (!emptyObject) body[pos++] = ',';
+        memcpy(body + pos, ACK_KEY, sizeof(ACK_KEY) - 1);
+        pos += sizeof(ACK_KEY) - 1;
+        pos += writeAcks(body + pos, capacity - pos - 3, attached);
     }
-    if (_sslClient.connected()) {
-        _sslClient.stop();
+
+    if (attached == 0) {
+        // Not even one ack fits - send the payload untouched
+        if (body == _txBuffer) {
+            _txBuffer[close] = '}';
+            _txBuffer[close + 1] = '\0';
+        }
+        return jsonPayload;
     }
 
-    // Explicitly connect first (R4 WiFiSSLClient quirk - helps with some servers)
+    body[pos++] = ']';
+    body[pos++] = '}';
+    body[pos] = '\0';
+    ackStart = body + close;
+
     if (_debugMode) {
-        logDebug("Connecting to " + String(host) + ":443...");
+        logDebug("Attached " + String(attached) + " command ack(s)");
     }
+    return body;
+}
 
-    if (!_sslClient.connect(host, 443)) {
-        if (_debugMode) {
-            logDebug("SSL connection failed!");
+// Write as many pending acks as fit in `capacity` bytes, comma separated
+// (no brackets or terminator). Returns the bytes written.
+size_t Inventronix::writeAcks(char* out, size_t capacity, int& attached) {
+    size_t pos = 0;
+    attached = 0;
+    for (int i = 0; i < _ackCount; i++) {
+        const CommandAck& ack = _acks[(_ackHead + i) % INVENTRONIX_ACK_BUFFER_SIZE];
+
+        // Format one ack object with the escaping Payload builder
+        char entry[INVENTRONIX_EXECUTION_ID_LENGTH + INVENTRONIX_ACK_RESULT_LENGTH + 64];
+        Payload ackJson(entry, sizeof(entry));
+        ackJson.add("execution_id", ack.executionId).add("success", ack.success);
+        if (ack.result[0] != '\0') {
+            ackJson.add("result", ack.result);
         }
-        return -3;  // Connection failed
+
+        size_t entryLength = ackJson.length();
+        size_t needed = (i > 0 ? 1 : 0) + entryLength;
+        if (pos + needed > capacity) break;
+        if (i > 0) out[pos++] = ',';
+        memcpy(out + pos, entry, entryLength);
+        pos += entryLength;
+        attached++;
     }
+    return pos;
+}
+
+// Cut the acks off a body again, leaving the payload it was built from
+void Inventronix::detachAcks(char* ackStart) {
+    if (ackStart == nullptr) return;
+    ackStart[0] = '}';
+    ackStart[1] = '\0';
+}
+
+// Forget acks the server has accepted
+void Inventronix::releaseAcks(int count) {
+    if (count > _ackCount) count = _ackCount;
+    _ackHead = (_ackHead + count) % INVENTRONIX_ACK_BUFFER_SIZE;
+    _ackCount -= count;
+}
+
+// Actual HTTP POST, through the active transport
+int Inventronix::sendHTTPRequest(const char* jsonPayload, String& responseBody) {
+    InventronixTransport& transport = _transport ? *_transport : _platformTransport;
+    String path = buildPath();
 
     if (_debugMode) {
-        logDebug("SSL connected, sending request...");
+        logDebug("POST " + buildURL());
+        logDebug("Payload: " + String(jsonPayload));
+        logDebug("Connecting to " + String(INVENTRONIX_API_HOST) + ":" + String(INVENTRONIX_API_PORT) + "...");
     }
 
-    HttpClient http(_sslClient, host, 443);
-    http.setTimeout(INVENTRONIX_HTTP_TIMEOUT);
+    int statusCode = transport.open(INVENTRONIX_API_HOST, INVENTRONIX_API_PORT, true);
+    if (statusCode < 0) {
+        if (_debugMode) {
+            logDebug("Connection failed!");
+        }
+        transport.close();
+        return statusCode;
+    }
 
-    http.beginRequest();
-    http.post(path);
-    http.sendHeader("Content-Type", "application/json");
-    http.sendHeader("X-Api-Key", _apiKey);
-    http.sendHeader("X-Project-Id", _projectId);
-    http.sendHeader("User-Agent", INVENTRONIX_USER_AGENT);
-    http.sendHeader("Content-Length", strlen(jsonPayload));
-    http.beginBody();
-    http.print(jsonPayload);
-    http.endRequest();
+    if (_debugMode) {
+        logDebug("Connected, sending request...");
+    }
 
-    int statusCode = http.responseStatusCode();
+    const InventronixHeader headers[] = {
+        {"Content-Type", "application/json"},
+        {"X-Api-Key", _apiKey.c_str()},
+        {"X-Project-Id", _projectId.c_str()},
+        {"User-Agent", INVENTRONIX_USER_AGENT},
+    };
+    InventronixRequest request;
+    request.method = "POST";
+    request.host = INVENTRONIX_API_HOST;
+    request.path = path.c_str();
+    request.headers = headers;
+    request.headerCount = sizeof(headers) / sizeof(headers[0]);
+    request.body = jsonPayload;
+    request.bodyLength = strlen(jsonPayload);
+
+    statusCode = transport.writeRequest(request);
+    if (statusCode == 0) {
+        statusCode = transport.readStatus();
+    }
 
-    // Get response body
+    // Headers first (the Date header syncs the server clock), then the body
     if (statusCode > 0) {
-        responseBody = http.responseBody();
-    }
+        String name;
+        String value;
+        while (transport.readHeader(name, value)) {
+            if (name.equalsIgnoreCase("Date")) {
+                syncServerClock(value.c_str());
+            }
+        }
 
-    // Clean up for next request
-    http.stop();
+        uint8_t chunk[INVENTRONIX_RESPONSE_CHUNK_SIZE];
+        int length;
+        while ((length = transport.readBody(chunk, sizeof(chunk))) > 0) {
+            responseBody.concat((const char*)chunk, (unsigned int)length);
+        }
+    }
 
-#endif
+    transport.close();
 
     if (_debugMode) {
         logDebug("Status: " + String(statusCode));
@@ -314,385 +692,2750 @@ void Inventronix::logDebug(const String& message) {
     }
 }
 
-// Connect to WiFi with timeout
-bool Inventronix::connectWiFi(const char* ssid, const char* password, unsigned long timeoutMs) {
-    _wifiSsid = String(ssid);
-    _wifiPassword = String(password);
-    _wifiManaged = true;
+// Radio levels seen by the WiFi state machine
+static const uint8_t RADIO_DOWN = 0;
+static const uint8_t RADIO_JOINED = 1;      // Associated, no IP yet
+static const uint8_t RADIO_HAS_IP = 2;
+static const uint8_t RADIO_LOST = 3;        // Dropped (event or status)
 
-    if (_verboseLogging) {
-        Serial.print("Connecting to WiFi");
-    }
+#ifdef INVENTRONIX_PLATFORM_ESP
+// Last good access point and DHCP lease. Kept in RTC memory, so it survives
+// deep sleep (not power loss); shared by every instance, like the radio.
+// leasedAt is system time, which the RTC timer keeps running through deep
+// sleep, so the lease's age is known after waking.
+struct WiFiCache {
+    uint32_t magic;
+    uint32_t ssidHash;
+    uint8_t bssid[6];
+    int32_t channel;
+    uint32_t ip;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    time_t leasedAt;            // When DHCP handed out `ip`
+};
+static const uint32_t WIFI_CACHE_MAGIC = 0x57494649;    // "WIFI"
+RTC_DATA_ATTR static WiFiCache s_wifiCache;
+
+// The cached lease may be reused without asking DHCP. Reusing it never
+// renews it at the server, so past INVENTRONIX_WIFI_LEASE_MAX_AGE_S (or if
+// the clock went backwards) the next join asks DHCP again.
+static bool wifiLeaseFresh() {
+    if (s_wifiCache.ip == 0) return false;
+    time_t now = time(nullptr);
+    return now >= s_wifiCache.leasedAt && now - s_wifiCache.leasedAt < INVENTRONIX_WIFI_LEASE_MAX_AGE_S;
+}
+#endif
 
-    WiFi.begin(ssid, password);
+// Start managing WiFi on one network without waiting; loop() and
+// sendPayload() move the connection along from here
+void Inventronix::beginWiFi(const char* ssid, const char* password) {
+    _wifiNetworkCount = 0;
+    addWiFiNetwork(ssid, password);
+    beginWiFi();
+}
 
-    unsigned long startTime = millis();
-    while (WiFi.status() != WL_CONNECTED) {
-        if (millis() - startTime > timeoutMs) {
-            if (_verboseLogging) {
-                Serial.println("\nWiFi connection timed out");
-            }
-            return false;
-        }
-        delay(500);
+// Add a network to choose from (replaces the password of a known SSID)
+bool Inventronix::addWiFiNetwork(const char* ssid, const char* password) {
+    uint32_t hash = InventronixDispatchIndex::hash(ssid);
+    int index = 0;
+    while (index < _wifiNetworkCount &&
+           !(_wifiNetworks[index].ssidHash == hash && _wifiNetworks[index].ssid == ssid)) {
+        index++;
+    }
+    if (index == INVENTRONIX_WIFI_MAX_NETWORKS) {
         if (_verboseLogging) {
-            Serial.print(".");
+            Serial.println("❌ WiFi network list is full");
         }
+        return false;
     }
 
-    // Wait for DHCP to assign a valid IP (R4 WiFi module is slow)
-    while (WiFi.localIP() == IPAddress(0, 0, 0, 0)) {
-        if (millis() - startTime > timeoutMs) {
-            if (_verboseLogging) {
-                Serial.println("\nDHCP timed out");
-            }
-            return false;
+    _wifiNetworks[index].ssid = String(ssid);
+    _wifiNetworks[index].password = String(password);
+    _wifiNetworks[index].ssidHash = hash;
+    if (index == _wifiNetworkCount) {
+        _wifiNetworkCount++;
+    }
+    return true;
+}
+
+// Start managing WiFi on the networks added with addWiFiNetwork()
+void Inventronix::beginWiFi() {
+    if (_wifiNetworkCount == 0) {
+        if (_verboseLogging) {
+            Serial.println("❌ No WiFi networks added");
         }
-        delay(100);
+        return;
     }
+    _wifiManaged = true;
+    _wifiBackoffMs = INVENTRONIX_WIFI_RETRY_MIN_MS;
 
-    if (_verboseLogging) {
-        Serial.println("\nWiFi connected");
-        Serial.print("   IP address: ");
-        Serial.println(WiFi.localIP());
+#ifdef INVENTRONIX_PLATFORM_ESP
+    // The library reconnects with its own backoff, and learns about the link
+    // from WiFi events instead of polling
+    WiFi.setAutoReconnect(false);
+    WiFi.persistent(false);     // Don't rewrite the credentials to flash on every begin()
+    if (!_wifiEventsAttached) {
+        _wifiEventId = WiFi.onEvent([this](arduino_event_id_t event, arduino_event_info_t info) {
+            switch (event) {
+                case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+                    _wifiRadio = RADIO_JOINED;
+                    break;
+                case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+                    _wifiRadio = RADIO_HAS_IP;
+                    break;
+                case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+                    // The echo of joinWiFi()'s own disconnect, arriving after
+                    // the new attempt started - not a failed join
+                    if (_wifiRadio == RADIO_DOWN &&
+                        info.wifi_sta_disconnected.reason == WIFI_REASON_ASSOC_LEAVE) {
+                        break;
+                    }
+                    _wifiRadio = RADIO_LOST;
+                    break;
+                case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+                    _wifiRadio = RADIO_LOST;
+                    break;
+                default:
+                    break;
+            }
+            wakeIdle();
+        });
+        _wifiEventsAttached = true;
     }
+#endif
 
-    return true;
+    startWiFiAttempt();
 }
 
-// Check if WiFi is connected
-bool Inventronix::isWiFiConnected() {
-    return WiFi.status() == WL_CONNECTED;
+// Connect to WiFi, waiting up to timeoutMs for the first connection. The
+// connection keeps being retried in the background if this times out.
+bool Inventronix::connectWiFi(const char* ssid, const char* password, unsigned long timeoutMs) {
+    _wifiNetworkCount = 0;
+    addWiFiNetwork(ssid, password);
+    return connectWiFi(timeoutMs);
 }
 
-// Try to reconnect WiFi (shorter timeout for auto-reconnect)
-bool Inventronix::tryReconnectWiFi(unsigned long timeoutMs) {
-    if (!_wifiManaged || _wifiSsid.length() == 0) {
-        return false;  // We don't have credentials
-    }
-
-    if (_verboseLogging) {
-        Serial.println("WiFi disconnected, reconnecting...");
-    }
-
-    WiFi.disconnect();
-    delay(100);
-    WiFi.begin(_wifiSsid.c_str(), _wifiPassword.c_str());
+bool Inventronix::connectWiFi(unsigned long timeoutMs) {
+    beginWiFi();
+    if (!_wifiManaged) return false;
 
     unsigned long startTime = millis();
-    while (WiFi.status() != WL_CONNECTED) {
+    while (_wifiState != WIFI_LINK_UP) {
         if (millis() - startTime > timeoutMs) {
             if (_verboseLogging) {
-                Serial.println("Reconnect timed out");
+                Serial.println("WiFi connection timed out (still retrying in loop())");
             }
             return false;
         }
-        delay(500);
-        if (_verboseLogging) {
-            Serial.print(".");
-        }
+        delay(10);
+        serviceWiFi();
     }
+    return true;
+}
 
-    if (_verboseLogging) {
-        Serial.println("\nReconnected to WiFi");
-    }
+// Check if WiFi is connected
+bool Inventronix::isWiFiConnected() {
+    return WiFi.status() == WL_CONNECTED;
+}
 
-    return true;
+// Current state of the managed connection
+WiFiLinkState Inventronix::wifiState() const {
+    return _wifiState;
 }
 
-// Ensure WiFi is connected, attempt reconnect if not
-bool Inventronix::ensureWiFi() {
-    if (WiFi.status() == WL_CONNECTED) {
-        return true;
-    }
+// Called from loop()/sendPayload() whenever the state changes
+void Inventronix::onWiFiStateChange(WiFiStateCallback callback) {
+    _wifiStateCallback = callback;
+}
 
-    // Try to reconnect if we have credentials
-    if (_wifiManaged) {
-        return tryReconnectWiFi();
+void Inventronix::setWiFiState(WiFiLinkState state) {
+    if (state == _wifiState) return;
+    _wifiState = state;
+    if (_wifiStateCallback) {
+        _wifiStateCallback(state);
     }
+}
 
-    // No credentials stored - user is managing WiFi themselves
-    if (_verboseLogging) {
-        Serial.println("WiFi not connected!");
-        Serial.println("   Use inventronix.connectWiFi(ssid, password) or connect manually");
-    }
-    return false;
+// Fixed address for every following connection attempt
+void Inventronix::setStaticIP(IPAddress ip, IPAddress gateway, IPAddress subnet, IPAddress dns) {
+    _staticIp = ip;
+    _staticGateway = gateway;
+    _staticSubnet = subnet;
+    _staticDns = (dns == IPAddress(0, 0, 0, 0)) ? gateway : dns;
+    _staticIpSet = true;
 }
 
-// Build the API URL with query parameters
-String Inventronix::buildURL() {
-    String url = String(INVENTRONIX_API_BASE_URL) +
-                 String(INVENTRONIX_INGEST_ENDPOINT);
+void Inventronix::clearWiFiCache() {
+#ifdef INVENTRONIX_PLATFORM_ESP
+    s_wifiCache.magic = 0;
+#endif
+}
 
-    // Add schema_id as query parameter if set
-    if (_schemaId.length() > 0) {
-        url += "?schema_id=" + _schemaId;
-    }
+// Proactive roaming: once the link has been weaker than thresholdDbm for
+// holdMs, look for an access point at least INVENTRONIX_WIFI_ROAM_MARGIN_DB
+// stronger and move to it (0 = never roam). Off by default on UNO R4, where
+// the scan holds up loop() for seconds.
+void Inventronix::setWiFiRoaming(int8_t thresholdDbm, unsigned long holdMs) {
+    _roamThresholdDbm = thresholdDbm;
+    _roamHoldMs = holdMs;
+    _wifiWeak = false;
+}
 
-    return url;
+// Signal strength of the current link
+int8_t Inventronix::wifiRSSI() {
+    if (_wifiState != WIFI_LINK_UP) return 0;
+    return (int8_t)WiFi.RSSI();
 }
 
-// ============================================
-// COMMAND HANDLING
-// ============================================
+// Network of the current link or attempt
+const char* Inventronix::wifiSSID() const {
+    bool joined = (_wifiState == WIFI_LINK_CONNECTING || _wifiState == WIFI_LINK_WAITING_IP ||
+                   _wifiState == WIFI_LINK_UP);
+    if (!joined || _wifiNetwork >= _wifiNetworkCount) return "";
+    return _wifiNetworks[_wifiNetwork].ssid.c_str();
+}
 
-// Register a toggle-style command handler
-void Inventronix::onCommand(const char* commandName, CommandCallback callback) {
-    if (_commandCount >= INVENTRONIX_MAX_COMMANDS) {
-        if (_verboseLogging) {
-            Serial.println("⚠️  Max commands registered, ignoring: " + String(commandName));
-        }
+// Moves to a stronger access point made while connected
+unsigned long Inventronix::wifiRoamCount() const {
+    return _wifiRoams;
+}
+
+// Begin a connection: on ESP32 straight to the cached access point (no
+// scan, reusing its DHCP lease), otherwise scan and try the strongest known
+// access points in turn. A single network on UNO R4 is joined without a
+// scan, since its module cannot be pointed at a particular access point.
+void Inventronix::startWiFiAttempt() {
+    _wifiCandidateCount = 0;
+    _wifiNextCandidate = 0;
+    _wifiRoamScan = false;
+    _wifiWeak = false;
+
+    int cached = cachedWiFiNetwork();
+    if (cached >= 0) {
+        _wifiFastAttempt = true;
+        joinWiFi(cached, nullptr);
         return;
     }
+    _wifiFastAttempt = false;
 
-    _commands[_commandCount].name = String(commandName);
-    _commands[_commandCount].callback = callback;
-    _commands[_commandCount].registered = true;
-    _commandCount++;
+#ifndef INVENTRONIX_PLATFORM_ESP
+    if (_wifiNetworkCount == 1) {
+        joinWiFi(0, nullptr);
+        return;
+    }
+#endif
+    startWiFiScan();
+}
 
+// Network matching the cached access point, or -1
+int Inventronix::cachedWiFiNetwork() {
+#ifdef INVENTRONIX_PLATFORM_ESP
+    if (s_wifiCache.magic != WIFI_CACHE_MAGIC) return -1;
+    for (int i = 0; i < _wifiNetworkCount; i++) {
+        if (_wifiNetworks[i].ssidHash == s_wifiCache.ssidHash) return i;
+    }
+#endif
+    return -1;
+}
+
+// Look for access points. Asynchronous on ESP32 (serviceWiFi() collects the
+// results); the UNO R4 module answers only when the scan is done.
+void Inventronix::startWiFiScan() {
     if (_verboseLogging) {
-        Serial.println("📝 Registered command: " + String(commandName));
+        Serial.println(_wifiRoamScan ? "🔍 Weak signal, scanning for a stronger access point"
+                                     : "🔍 Scanning for WiFi networks");
+    }
+    _wifiAttemptAt = millis();
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+    if (!_wifiRoamScan) {
+        _wifiRadio = RADIO_DOWN;
+        WiFi.mode(WIFI_STA);
+        WiFi.disconnect();
+        setWiFiState(WIFI_LINK_SCANNING);
+    }
+    if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) {
+        finishWiFiScan(WIFI_SCAN_FAILED);
+    }
+#else
+    if (!_wifiRoamScan) {
+        setWiFiState(WIFI_LINK_SCANNING);
     }
+    finishWiFiScan(WiFi.scanNetworks());
+#endif
 }
 
-// Register a pulse command - simple pin-based version
-void Inventronix::onPulse(const char* commandName, int pin, unsigned long durationMs) {
-    if (_pulseCount >= INVENTRONIX_MAX_PULSES) {
+// Act on a finished scan: join the strongest known access point, or (when
+// roaming) move to one clearly stronger than the current link. Returns
+// false if the scan found nothing to join.
+bool Inventronix::finishWiFiScan(int found) {
+    bool roaming = _wifiRoamScan;
+    _wifiRoamScan = false;
+    rankWiFiScan(found);
+
+    if (roaming) {
+        _roamScanAt = millis() + INVENTRONIX_WIFI_ROAM_SCAN_INTERVAL_MS;
+        _wifiWeak = false;
+        if (_wifiCandidateCount == 0) return false;
+
+        const WiFiCandidate& best = _wifiCandidates[0];
+        bool sameAccessPoint = (best.network == _wifiNetwork);
+#ifdef INVENTRONIX_PLATFORM_ESP
+        uint8_t* bssid = WiFi.BSSID();
+        sameAccessPoint = sameAccessPoint && bssid != nullptr &&
+                          memcmp(best.bssid, bssid, sizeof(best.bssid)) == 0;
+#endif
+        if (sameAccessPoint || best.rssi < _wifiRssi + INVENTRONIX_WIFI_ROAM_MARGIN_DB) {
+            if (_verboseLogging) {
+                Serial.println("📶 No stronger access point in range");
+            }
+            return false;
+        }
+
         if (_verboseLogging) {
-            Serial.println("⚠️  Max pulse commands registered, ignoring: " + String(commandName));
+            Serial.print("📶 Roaming from ");
+            Serial.print(_wifiRssi);
+            Serial.print(" dBm to ");
+            Serial.print(_wifiNetworks[best.network].ssid);
+            Serial.print(" at ");
+            Serial.print(best.rssi);
+            Serial.println(" dBm");
         }
-        return;
+        _wifiRoams++;
+        _wifiNextCandidate = 1;
+        joinWiFi(best.network, &best);
+        return true;
     }
 
-    _pulses[_pulseCount].name = String(commandName);
-    _pulses[_pulseCount].pin = pin;
-    _pulses[_pulseCount].durationMs = durationMs;  // 0 = pull from args
-    _pulses[_pulseCount].onCallback = nullptr;
-    _pulses[_pulseCount].offCallback = nullptr;
-    _pulses[_pulseCount].active = false;
-    _pulses[_pulseCount].registered = true;
+    if (_wifiCandidateCount == 0 && found >= 0) {
+        // Hidden networks do not show up in scans: try each one by name
+        if (_verboseLogging) {
+            Serial.println("⚠️  No known network seen in the scan, trying each by name");
+        }
+        for (int n = 0; n < _wifiNetworkCount && n < INVENTRONIX_WIFI_MAX_CANDIDATES; n++) {
+            WiFiCandidate& candidate = _wifiCandidates[_wifiCandidateCount++];
+            candidate.network = (uint8_t)n;
+            candidate.rssi = 0;
+            candidate.channel = 0;
+            memset(candidate.bssid, 0, sizeof(candidate.bssid));
+        }
+    }
+    if (_wifiCandidateCount == 0) {
+        failWiFiAttempt("WiFi scan failed");
+        return false;
+    }
+    _wifiNextCandidate = 1;
+    joinWiFi(_wifiCandidates[0].network, &_wifiCandidates[0]);
+    return true;
+}
+
+// Keep the known access points from the scan results, strongest first
+void Inventronix::rankWiFiScan(int found) {
+    _wifiCandidateCount = 0;
+    _wifiNextCandidate = 0;
+
+    for (int i = 0; i < found; i++) {
+        String ssid = WiFi.SSID(i);
+        uint32_t hash = InventronixDispatchIndex::hash(ssid.c_str());
+        int network = -1;
+        for (int n = 0; n < _wifiNetworkCount && network < 0; n++) {
+            if (_wifiNetworks[n].ssidHash == hash && _wifiNetworks[n].ssid == ssid) {
+                network = n;
+            }
+        }
+        if (network < 0) continue;
+
+        WiFiCandidate candidate;
+        candidate.network = (uint8_t)network;
+        candidate.rssi = (int8_t)WiFi.RSSI(i);
+#ifdef INVENTRONIX_PLATFORM_ESP
+        uint8_t* bssid = WiFi.BSSID(i);
+        if (bssid == nullptr) continue;
+        memcpy(candidate.bssid, bssid, sizeof(candidate.bssid));
+        candidate.channel = WiFi.channel(i);
+#else
+        // The module joins by SSID only: keep the strongest sighting
+        memset(candidate.bssid, 0, sizeof(candidate.bssid));
+        candidate.channel = 0;
+        int seen = -1;
+        for (int c = 0; c < _wifiCandidateCount && seen < 0; c++) {
+            if (_wifiCandidates[c].network == network) seen = c;
+        }
+        if (seen >= 0) {
+            if (_wifiCandidates[seen].rssi >= candidate.rssi) continue;
+            for (int c = seen; c + 1 < _wifiCandidateCount; c++) {
+                _wifiCandidates[c] = _wifiCandidates[c + 1];
+            }
+            _wifiCandidateCount--;
+        }
+#endif
+
+        // Insertion into the sorted list; the weakest falls off a full one
+        int position = _wifiCandidateCount;
+        while (position > 0 && _wifiCandidates[position - 1].rssi < candidate.rssi) {
+            position--;
+        }
+        if (position >= INVENTRONIX_WIFI_MAX_CANDIDATES) continue;
+        int last = (_wifiCandidateCount < INVENTRONIX_WIFI_MAX_CANDIDATES)
+                       ? _wifiCandidateCount : INVENTRONIX_WIFI_MAX_CANDIDATES - 1;
+        for (int c = last; c > position; c--) {
+            _wifiCandidates[c] = _wifiCandidates[c - 1];
+        }
+        _wifiCandidates[position] = candidate;
+        if (_wifiCandidateCount < INVENTRONIX_WIFI_MAX_CANDIDATES) {
+            _wifiCandidateCount++;
+        }
+    }
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+    WiFi.scanDelete();
+#endif
+}
+
+// Issue one join attempt: to a scanned access point (its BSSID and channel
+// on ESP32), the cached one, or by SSID. WiFi.begin() returns at once on
+// ESP32; the UNO R4 module may hold it while it associates.
+void Inventronix::joinWiFi(int network, const WiFiCandidate* accessPoint) {
+    _wifiNetwork = (uint8_t)network;
+    const WiFiNetwork& target = _wifiNetworks[network];
+
+    if (_verboseLogging) {
+        Serial.print("📶 Connecting to WiFi: ");
+        Serial.print(target.ssid);
+        if (_wifiFastAttempt) {
+            Serial.println(" (cached access point)");
+        } else if (accessPoint != nullptr && accessPoint->rssi != 0) {
+            Serial.print(" (");
+            Serial.print(accessPoint->rssi);
+            Serial.println(" dBm)");
+        } else {
+            Serial.println();
+        }
+    }
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+    if (_wifiRadio != RADIO_DOWN) {
+        WiFi.disconnect();
+    }
+    _wifiRadio = RADIO_DOWN;
+#else
+    WiFi.disconnect();
+#endif
+    applyWiFiAddress();
+    _wifiAttemptAt = millis();
+    setWiFiState(WIFI_LINK_CONNECTING);
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+    if (_wifiFastAttempt) {
+        WiFi.begin(target.ssid.c_str(), target.password.c_str(), s_wifiCache.channel, s_wifiCache.bssid);
+        return;
+    }
+    if (accessPoint != nullptr && accessPoint->channel != 0) {
+        WiFi.begin(target.ssid.c_str(), target.password.c_str(), accessPoint->channel, accessPoint->bssid);
+        return;
+    }
+#else
+    (void)accessPoint;
+#endif
+    WiFi.begin(target.ssid.c_str(), target.password.c_str());
+}
+
+// An attempt (or scan) failed: try the next access point from the scan, or
+// back off, doubling up to the maximum
+void Inventronix::failWiFiAttempt(const char* reason) {
+    if (_wifiNextCandidate < _wifiCandidateCount) {
+        if (_verboseLogging) {
+            Serial.print("❌ ");
+            Serial.print(reason);
+            Serial.println(", trying the next access point");
+        }
+        const WiFiCandidate& next = _wifiCandidates[_wifiNextCandidate++];
+        joinWiFi(next.network, &next);
+        return;
+    }
+
+    _wifiRetryAt = millis() + _wifiBackoffMs;
+    if (_verboseLogging) {
+        Serial.print("❌ ");
+        Serial.print(reason);
+        Serial.print(", retrying in ");
+        Serial.print(_wifiBackoffMs);
+        Serial.println("ms");
+    }
+    _wifiBackoffMs *= 2;
+    if (_wifiBackoffMs > INVENTRONIX_WIFI_RETRY_MAX_MS) {
+        _wifiBackoffMs = INVENTRONIX_WIFI_RETRY_MAX_MS;
+    }
+    setWiFiState(WIFI_LINK_RETRY_WAIT);
+}
+
+// Sample the link's RSSI; once it has stayed under the threshold for the
+// hold time, scan (at most every INVENTRONIX_WIFI_ROAM_SCAN_INTERVAL_MS)
+void Inventronix::checkRoaming(unsigned long now) {
+    if (_roamThresholdDbm == 0 || now - _wifiRssiAt < INVENTRONIX_WIFI_RSSI_POLL_MS) return;
+    _wifiRssiAt = now;
+    _wifiRssi = (int8_t)WiFi.RSSI();
+
+    if (_wifiRssi == 0 || _wifiRssi >= _roamThresholdDbm) {
+        _wifiWeak = false;
+        return;
+    }
+    if (!_wifiWeak) {
+        _wifiWeak = true;
+        _wifiWeakSince = now;
+    }
+    if (now - _wifiWeakSince >= _roamHoldMs && (long)(now - _roamScanAt) >= 0) {
+        _wifiRoamScan = true;
+        startWiFiScan();
+    }
+}
+
+// Static IP, the cached lease (skips DHCP), or DHCP
+void Inventronix::applyWiFiAddress() {
+#ifdef INVENTRONIX_PLATFORM_ESP
+    if (_staticIpSet) {
+        WiFi.config(_staticIp, _staticGateway, _staticSubnet, _staticDns);
+        _wifiAddressFixed = true;
+    } else if (INVENTRONIX_WIFI_REUSE_LEASE && _wifiFastAttempt && wifiLeaseFresh()) {
+        WiFi.config(IPAddress(s_wifiCache.ip), IPAddress(s_wifiCache.gateway),
+                    IPAddress(s_wifiCache.subnet), IPAddress(s_wifiCache.dns));
+        _wifiAddressFixed = true;
+    } else if (_wifiAddressFixed) {
+        // Back to DHCP
+        WiFi.config(IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0));
+        _wifiAddressFixed = false;
+    }
+#else
+    if (_staticIpSet) {
+        WiFi.config(_staticIp, _staticDns, _staticGateway, _staticSubnet);
+    }
+#endif
+}
+
+// Remember the access point and lease that just worked
+void Inventronix::saveWiFiCache() {
+#ifdef INVENTRONIX_PLATFORM_ESP
+    uint8_t* bssid = WiFi.BSSID();
+    if (bssid == nullptr) return;
+
+    s_wifiCache.ssidHash = _wifiNetworks[_wifiNetwork].ssidHash;
+    memcpy(s_wifiCache.bssid, bssid, sizeof(s_wifiCache.bssid));
+    s_wifiCache.channel = WiFi.channel();
+    if (!_wifiAddressFixed) {
+        // A fresh lease from DHCP. One reused from the cache keeps its age.
+        s_wifiCache.ip = (uint32_t)WiFi.localIP();
+        s_wifiCache.gateway = (uint32_t)WiFi.gatewayIP();
+        s_wifiCache.subnet = (uint32_t)WiFi.subnetMask();
+        s_wifiCache.dns = (uint32_t)WiFi.dnsIP(0);
+        s_wifiCache.leasedAt = time(nullptr);
+    } else if (_staticIpSet) {
+        s_wifiCache.ip = 0;     // Not a lease
+    }
+    s_wifiCache.magic = WIFI_CACHE_MAGIC;
+#endif
+}
+
+// Where the radio is now: from WiFi events on ESP32, polled on the R4 (where
+// each query is a round trip to the WiFi module, so the IP is only read
+// when needed)
+uint8_t Inventronix::readWiFiRadio(bool needIp) {
+#ifdef INVENTRONIX_PLATFORM_ESP
+    (void)needIp;
+    return _wifiRadio;
+#else
+    uint8_t status = WiFi.status();
+    if (status == WL_CONNECTED) {
+        if (needIp && WiFi.localIP() == IPAddress(0, 0, 0, 0)) {
+            return RADIO_JOINED;
+        }
+        return RADIO_HAS_IP;
+    }
+    if (status == WL_CONNECTION_LOST || status == WL_CONNECT_FAILED) {
+        return RADIO_LOST;
+    }
+    return RADIO_DOWN;
+#endif
+}
+
+// Move the managed connection along. Never waits: each call looks at the
+// radio once and changes state if needed.
+void Inventronix::serviceWiFi() {
+    if (!_wifiManaged) return;
+
+    unsigned long now = millis();
+#ifndef INVENTRONIX_PLATFORM_ESP
+    if (now - _wifiPolledAt < INVENTRONIX_WIFI_POLL_MS) return;
+    _wifiPolledAt = now;
+#endif
+
+    switch (_wifiState) {
+        case WIFI_LINK_CONNECTING:
+        case WIFI_LINK_WAITING_IP: {
+            uint8_t radio = readWiFiRadio(true);
+            if (radio == RADIO_HAS_IP) {
+                _wifiBackoffMs = INVENTRONIX_WIFI_RETRY_MIN_MS;
+                saveWiFiCache();
+                if (_verboseLogging) {
+                    Serial.print("✅ WiFi connected in ");
+                    Serial.print(now - _wifiAttemptAt);
+                    Serial.print(_wifiFastAttempt ? "ms (cached), IP address: " : "ms, IP address: ");
+                    Serial.println(WiFi.localIP());
+                }
+                _wifiRssiAt = now;
+                _wifiWeak = false;
+                setWiFiState(WIFI_LINK_UP);
+            } else if (_wifiFastAttempt && (radio == RADIO_LOST ||
+                                            now - _wifiAttemptAt > INVENTRONIX_WIFI_FAST_TIMEOUT_MS)) {
+                // The cached access point refused us or did not answer - scan straight away
+                if (_verboseLogging) {
+                    Serial.println(radio == RADIO_LOST ? "⚠️  Cached access point refused the join, scanning"
+                                                       : "⚠️  Cached access point did not answer, scanning");
+                }
+                clearWiFiCache();
+                startWiFiAttempt();
+            } else if (radio == RADIO_LOST) {
+                // Wrong password, no such network, or dropped before DHCP -
+                // no point waiting out the attempt timeout
+                failWiFiAttempt(_wifiState == WIFI_LINK_WAITING_IP ? "WiFi dropped before DHCP" : "WiFi join failed");
+            } else if (now - _wifiAttemptAt > INVENTRONIX_WIFI_ATTEMPT_TIMEOUT_MS) {
+                failWiFiAttempt(radio == RADIO_JOINED ? "DHCP timed out" : "WiFi join timed out");
+            } else if (radio == RADIO_JOINED) {
+                setWiFiState(WIFI_LINK_WAITING_IP);
+            }
+            break;
+        }
+
+        case WIFI_LINK_UP: {
+            uint8_t radio = readWiFiRadio(false);
+            if (radio == RADIO_DOWN || radio == RADIO_LOST) {
+                if (_verboseLogging) {
+                    Serial.println("📴 WiFi disconnected, reconnecting...");
+                }
+                startWiFiAttempt();
+                break;
+            }
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+            if (_wifiRoamScan) {
+                int found = WiFi.scanComplete();
+                if (found != WIFI_SCAN_RUNNING) {
+                    finishWiFiScan(found);
+                } else if (now - _wifiAttemptAt > INVENTRONIX_WIFI_SCAN_TIMEOUT_MS) {
+                    WiFi.scanDelete();
+                    finishWiFiScan(0);
+                }
+                break;
+            }
+#endif
+            checkRoaming(now);
+            break;
+        }
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+        case WIFI_LINK_SCANNING: {
+            int found = WiFi.scanComplete();
+            if (found != WIFI_SCAN_RUNNING) {
+                finishWiFiScan(found);
+            } else if (now - _wifiAttemptAt > INVENTRONIX_WIFI_SCAN_TIMEOUT_MS) {
+                WiFi.scanDelete();
+                finishWiFiScan(WIFI_SCAN_FAILED);
+            }
+            break;
+        }
+#endif
+
+        case WIFI_LINK_RETRY_WAIT:
+            if ((long)(now - _wifiRetryAt) >= 0) {
+                startWiFiAttempt();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Is the link up? Never blocks: a managed connection that is down is being
+// retried by serviceWiFi(), so the caller fails fast.
+bool Inventronix::ensureWiFi() {
+    if (_wifiManaged) {
+        serviceWiFi();
+        if (_wifiState == WIFI_LINK_UP) {
+            return true;
+        }
+        if (_verboseLogging) {
+            Serial.println("📴 WiFi not connected yet, not sending");
+        }
+        return false;
+    }
+
+    if (WiFi.status() == WL_CONNECTED) {
+        return true;
+    }
+
+    // No credentials stored - user is managing WiFi themselves
+    if (_verboseLogging) {
+        Serial.println("WiFi not connected!");
+        Serial.println("   Use inventronix.connectWiFi(ssid, password) or connect manually");
+    }
+    return false;
+}
+
+// Build the API URL with query parameters
+String Inventronix::buildURL() {
+    return String(INVENTRONIX_API_BASE_URL) + buildPath();
+}
+
+// Ingest path, with schema_id as a query parameter if set
+String Inventronix::buildPath() {
+    String path = String(INVENTRONIX_INGEST_ENDPOINT);
+    if (_schemaId.length() > 0) {
+        path += "?schema_id=" + _schemaId;
+    }
+    return path;
+}
+
+// ============================================
+// COMMAND HANDLING
+// ============================================
+
+// Register a toggle-style command handler
+void Inventronix::onCommand(const char* commandName, CommandCallback callback) {
+    if (_commandCount >= INVENTRONIX_MAX_COMMANDS) {
+        if (_verboseLogging) {
+            Serial.println("⚠️  Max commands registered, ignoring: " + String(commandName));
+        }
+        return;
+    }
+
+    if (!_dispatchIndex.insert(InventronixDispatchIndex::hash(commandName), (uint16_t)_commandCount)) {
+        if (_verboseLogging) {
+            Serial.println("⚠️  Out of memory for commands, ignoring: " + String(commandName));
+        }
+        return;
+    }
+    _commands[_commandCount].name = String(commandName);
+    _commands[_commandCount].callback = callback;
+    _commands[_commandCount].registered = true;
+    _commandCount++;
+
+    if (_verboseLogging) {
+        Serial.println("📝 Registered command: " + String(commandName));
+    }
+}
+
+// A typed command's arguments failed their checks - ack the failure
+// instead of running the handler
+void Inventronix::rejectArgs(const char* key, ArgError error) {
+    if (_verboseLogging) {
+        Serial.print("   ❌ Bad argument '");
+        Serial.print(key);
+        Serial.print("': ");
+        Serial.println(argErrorName(error));
+    }
+    setCommandResult(false, argErrorName(error));
+}
+
+// Register a pulse command - simple pin-based version
+void Inventronix::onPulse(const char* commandName, int pin, unsigned long durationMs) {
+    PulseHandler* pulse = addPulse(commandName);
+    if (pulse == nullptr) return;
+
+    pulse->pin = pin;
+    pulse->durationMs = durationMs;  // 0 = pull from args
 
     // Ensure pin is configured as output
     pinMode(pin, OUTPUT);
     digitalWrite(pin, LOW);
 
-    _pulseCount++;
+    if (_verboseLogging) {
+        Serial.print("📝 Registered pulse command: " + String(commandName));
+        Serial.print(" (pin ");
+        Serial.print(pin);
+        if (durationMs > 0) {
+            Serial.print(", ");
+            Serial.print(durationMs);
+            Serial.print("ms");
+        } else {
+            Serial.print(", duration from args");
+        }
+        Serial.println(")");
+    }
+}
+
+// Register a pulse command - callback-based version
+void Inventronix::onPulse(const char* commandName, unsigned long durationMs,
+                          PulseOnCallback onCb, PulseOffCallback offCb) {
+    PulseHandler* pulse = addPulse(commandName);
+    if (pulse == nullptr) return;
+
+    pulse->pin = -1;  // Using callbacks, not direct pin
+    pulse->durationMs = durationMs;
+    pulse->onCallback = onCb;
+    pulse->offCallback = offCb;
+
+    if (_verboseLogging) {
+        Serial.print("📝 Registered pulse command: " + String(commandName));
+        Serial.print(" (callback, ");
+        if (durationMs > 0) {
+            Serial.print(durationMs);
+            Serial.print("ms");
+        } else {
+            Serial.print("duration from args");
+        }
+        Serial.println(")");
+    }
+}
+
+// Register a pulse command whose edges are generated by hardware
+void Inventronix::onPrecisionPulse(const char* commandName, int pin, unsigned long durationMs) {
+    if (durationMs > INVENTRONIX_PRECISION_PULSE_MAX_MS) {
+        if (_verboseLogging) {
+            Serial.println("⚠️  Precision pulse too long, ignoring: " + String(commandName));
+        }
+        return;
+    }
+
+    // Register the pin as a normal pulse (pinMode, LOW, indexing) first
+    onPulse(commandName, pin, durationMs);
+    int i = findPulse(commandName, InventronixDispatchIndex::hash(commandName));
+    if (i < 0) return;
+
+    bool hardware = false;
+#if defined(INVENTRONIX_PRECISION_RMT)
+    // The RMT channel owns the pin from here on and idles it LOW
+    hardware = rmtInit(pin, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_1, RMT_RESOLUTION_HZ) &&
+               rmtSetEOT(pin, LOW);
+#elif defined(INVENTRONIX_PRECISION_GPT)
+    hardware = beginPrecisionTimer();
+#endif
+    _pulses[i]->precision = hardware;
+
+    if (!hardware && _verboseLogging) {
+        Serial.println("⚠️  No hardware timer for precision pulse, using the pulse timer: " +
+                       String(commandName));
+    }
+}
+
+// Start a registered pulse without a server command
+bool Inventronix::triggerPulse(const char* commandName, unsigned long durationMs) {
+    int i = findPulse(commandName, InventronixDispatchIndex::hash(commandName));
+    if (i < 0) return false;
+    if (durationMs == 0) {
+        durationMs = _pulses[i]->durationMs;
+    }
+    if (durationMs == 0) return false;
+    return beginPulse(i, durationMs) == nullptr;
+}
+
+// Allocate and index a new pulse handler (nullptr if out of memory)
+PulseHandler* Inventronix::addPulse(const char* commandName) {
+    // Indexes share the dispatch value with the handler kind bits
+    if (_pulseCount > (int)DISPATCH_INDEX_MASK) return nullptr;
+
+    PulseHandler* pulse = new (std::nothrow) PulseHandler();
+    bool ok = (pulse != nullptr);
+
+    if (ok && _pulseCount == _pulseCapacity) {
+        // Grow into new storage, then swap it in under the lock so the pulse
+        // timer never sees a half-moved registry
+        int capacity = (_pulseCapacity > 0) ? _pulseCapacity * 2 : 4;
+        PulseHandler** pulses = (PulseHandler**)malloc(capacity * sizeof(PulseHandler*));
+        InventronixPulseHeap queue;
+        ok = (pulses != nullptr) && queue.reserve(capacity);
+#ifdef INVENTRONIX_PRECISION_GPT
+        InventronixPulseHeap precisionQueue;
+        ok = ok && precisionQueue.reserve(capacity);
+#endif
+
+        if (ok) {
+            if (_pulseCount > 0) {
+                memcpy(pulses, _pulses, _pulseCount * sizeof(PulseHandler*));
+            }
+            PULSE_LOCK();
+            queue.copyFrom(_pulseQueue);
+            queue.swap(_pulseQueue);
+#ifdef INVENTRONIX_PRECISION_GPT
+            precisionQueue.copyFrom(_precisionQueue);
+            precisionQueue.swap(_precisionQueue);
+#endif
+            PulseHandler** old = _pulses;
+            _pulses = pulses;
+            pulses = old;
+            PULSE_UNLOCK();
+            _pulseCapacity = capacity;
+        }
+        free(pulses);   // The old registry (or the new one, on failure)
+    }
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+    if (ok && _pulseTimer == nullptr) {
+        esp_timer_create_args_t timerArgs = {};
+        timerArgs.callback = pulseTimerCallback;
+        timerArgs.arg = this;
+        timerArgs.dispatch_method = ESP_TIMER_TASK;
+        timerArgs.name = "inventronix_pulse";
+        ok = (esp_timer_create(&timerArgs, &_pulseTimer) == ESP_OK);
+    }
+#endif
+
+    if (!ok) {
+        delete pulse;
+        if (_verboseLogging) {
+            Serial.println("⚠️  Out of memory for pulse commands, ignoring: " + String(commandName));
+        }
+        return nullptr;
+    }
+
+    pulse->name = String(commandName);
+    pulse->pin = -1;
+    pulse->durationMs = 0;
+    pulse->precision = false;
+#ifdef INVENTRONIX_PRECISION_RMT
+    pulse->symbols = nullptr;
+    pulse->symbolCapacity = 0;
+#endif
+    pulse->state = PULSE_IDLE;
+    pulse->policy = PULSE_IGNORE;
+    pulse->minGapMs = 0;
+    pulse->followOns = nullptr;
+    pulse->followLimit = 0;
+    pulse->followHead = 0;
+    pulse->followCount = 0;
+    pulse->stats = PulseStats();
+    pulse->registered = true;
+
+    if (!_dispatchIndex.insert(InventronixDispatchIndex::hash(commandName),
+                               (uint16_t)(_pulseCount | DISPATCH_PULSE_FLAG))) {
+        delete pulse;
+        if (_verboseLogging) {
+            Serial.println("⚠️  Out of memory for pulse commands, ignoring: " + String(commandName));
+        }
+        return nullptr;
+    }
+    _pulses[_pulseCount] = pulse;
+    _pulseCount++;
+    return pulse;
+}
+
+// Register a PWM command
+void Inventronix::onPwm(const char* commandName, int pin, uint32_t frequencyHz) {
+    if (_pwmCount >= INVENTRONIX_MAX_PWM || !_pwmQueue.reserve(INVENTRONIX_MAX_PWM)) {
+        if (_verboseLogging) {
+            Serial.println("⚠️  Max PWM commands registered, ignoring: " + String(commandName));
+        }
+        return;
+    }
+
+    PwmHandler& pwm = _pwm[_pwmCount];
+    pwm.name = String(commandName);
+    pwm.pin = pin;
+    pwm.frequencyHz = frequencyHz;
+    pwm.defaultRampMs = 0;
+    pwm.stepCount = 0;
+    pwm.stepIndex = 0;
+    pwm.repeatsLeft = 0;
+    pwm.duty = 0;
+    pwm.ramping = false;
+
+    // Start the output at 0% duty
+    bool attached;
+#if defined(INVENTRONIX_LEDC_PIN_API)
+    attached = ledcAttach(pin, frequencyHz, INVENTRONIX_PWM_RESOLUTION);
+#elif defined(INVENTRONIX_PLATFORM_ESP)
+    pwm.channel = s_nextLedcChannel;
+    attached = ledcSetup(pwm.channel, frequencyHz, INVENTRONIX_PWM_RESOLUTION) > 0;
+    if (attached) {
+        ledcAttachPin(pin, pwm.channel);
+        s_nextLedcChannel += 2;
+    }
+#else
+    pwm.output = new (std::nothrow) PwmOut(pin);
+    attached = (pwm.output != nullptr) && pwm.output->begin((float)frequencyHz, 0.0f);
+#endif
+    if (!attached) {
+#ifdef INVENTRONIX_PLATFORM_RENESAS
+        delete pwm.output;
+#endif
+        if (_verboseLogging) {
+            Serial.println("⚠️  Could not start PWM on pin " + String(pin) + ", ignoring: " + String(commandName));
+        }
+        return;
+    }
+    if (!_dispatchIndex.insert(InventronixDispatchIndex::hash(commandName),
+                               (uint16_t)(_pwmCount | DISPATCH_PWM_FLAG))) {
+        // Hand the pin back
+#if defined(INVENTRONIX_LEDC_PIN_API)
+        ledcDetach(pin);
+#elif defined(INVENTRONIX_PLATFORM_ESP)
+        ledcDetachPin(pin);
+        s_nextLedcChannel -= 2;
+#else
+        delete pwm.output;
+#endif
+        if (_verboseLogging) {
+            Serial.println("⚠️  Out of memory for PWM commands, ignoring: " + String(commandName));
+        }
+        return;
+    }
+    writePwm(pwm, 0);
+
+    pwm.registered = true;
+    _pwmCount++;
+
+    if (_verboseLogging) {
+        Serial.print("📝 Registered PWM command: " + String(commandName));
+        Serial.print(" (pin ");
+        Serial.print(pin);
+        Serial.print(", ");
+        Serial.print(frequencyHz);
+        Serial.println("Hz)");
+    }
+}
+
+// Register a PWM command that ramps by default
+void Inventronix::onRamp(const char* commandName, int pin, unsigned long rampMs, uint32_t frequencyHz) {
+    onPwm(commandName, pin, frequencyHz);
+    int i = findPwm(commandName, InventronixDispatchIndex::hash(commandName));
+    if (i >= 0) {
+        _pwm[i].defaultRampMs = rampMs;
+    }
+}
+
+// Current duty of a PWM command in percent
+float Inventronix::pwmDuty(const char* commandName) {
+    int i = findPwm(commandName, InventronixDispatchIndex::hash(commandName));
+    return (i >= 0) ? _pwm[i].duty / 100.0f : 0.0f;
+}
+
+// Register an output group - resolve every pin to its port register and bit
+void Inventronix::onOutputGroup(const char* commandName, const int* pins, uint8_t pinCount) {
+    if (_groupCount >= INVENTRONIX_MAX_OUTPUT_GROUPS || pinCount == 0 ||
+        pinCount > INVENTRONIX_OUTPUT_GROUP_MAX_PINS) {
+        if (_verboseLogging) {
+            Serial.println("⚠️  Cannot register output group, ignoring: " + String(commandName));
+        }
+        return;
+    }
+
+    OutputGroup& group = _groups[_groupCount];
+    group.portCount = 0;
+    group.state = 0;
+
+    for (uint8_t k = 0; k < pinCount; k++) {
+        volatile uint32_t* outRegister = nullptr;
+        uint32_t bit = 0;
+#ifdef INVENTRONIX_PLATFORM_ESP
+        // GPIO 0-31 and 32+ live in separate output registers
+        if (pins[k] < 32) {
+            outRegister = (volatile uint32_t*)GPIO_OUT_REG;
+            bit = 1UL << pins[k];
+        } else {
+#ifdef GPIO_OUT1_REG
+            outRegister = (volatile uint32_t*)GPIO_OUT1_REG;
+            bit = 1UL << (pins[k] - 32);
+#endif
+        }
+#else
+        // PCNTR3 sets (low half) and resets (high half) a whole port in one write
+        bsp_io_port_pin_t ioPin = digitalPinToBspPin(pins[k]);
+        uintptr_t portStride = (uintptr_t)R_PORT1 - (uintptr_t)R_PORT0;
+        R_PORT0_Type* port = (R_PORT0_Type*)((uintptr_t)R_PORT0 + portStride * ((uint32_t)ioPin >> 8));
+        outRegister = &port->PCNTR3;
+        bit = 1UL << ((uint32_t)ioPin & 0xFF);
+#endif
+
+        // Find (or add) this pin's port
+        int p = 0;
+        while (p < group.portCount && group.outRegister[p] != outRegister) {
+            p++;
+        }
+        if (outRegister == nullptr || p >= INVENTRONIX_OUTPUT_GROUP_MAX_PORTS) {
+            if (_verboseLogging) {
+                Serial.println("⚠️  Output group pin " + String(pins[k]) + " not supported, ignoring: " +
+                               String(commandName));
+            }
+            return;
+        }
+        if (p == group.portCount) {
+            group.outRegister[p] = outRegister;
+            group.portCount++;
+        }
+        group.pinPort[k] = (uint8_t)p;
+        group.pinMask[k] = bit;
+    }
+
+    if (!_dispatchIndex.insert(InventronixDispatchIndex::hash(commandName),
+                               (uint16_t)(_groupCount | DISPATCH_GROUP_FLAG))) {
+        if (_verboseLogging) {
+            Serial.println("⚠️  Out of memory for output groups, ignoring: " + String(commandName));
+        }
+        return;
+    }
+    group.name = String(commandName);
+    group.pinCount = pinCount;
+    group.registered = true;
+
+    // Outputs, all starting LOW
+    for (uint8_t k = 0; k < pinCount; k++) {
+        pinMode(pins[k], OUTPUT);
+    }
+    applyOutputGroup(group, 0, 0xFFFFFFFF);
+    _groupCount++;
+
+    if (_verboseLogging) {
+        Serial.print("📝 Registered output group: " + String(commandName));
+        Serial.print(" (");
+        Serial.print(pinCount);
+        Serial.println(" pins)");
+    }
+}
+
+// Apply a bitmap to an output group without a server command
+bool Inventronix::setOutputGroup(const char* commandName, uint32_t bits, uint32_t mask) {
+    int i = findOutputGroup(commandName, InventronixDispatchIndex::hash(commandName));
+    if (i < 0) return false;
+    applyOutputGroup(_groups[i], bits, mask);
+    return true;
+}
+
+// Last bitmap applied to an output group
+uint32_t Inventronix::outputGroupState(const char* commandName) {
+    int i = findOutputGroup(commandName, InventronixDispatchIndex::hash(commandName));
+    return (i >= 0) ? _groups[i].state : 0;
+}
+
+// Look up a toggle command slot by name (-1 if not registered)
+int Inventronix::findCommand(const char* name, uint32_t nameHash) {
+    return _dispatchIndex.find(nameHash, [&](uint16_t value) {
+        return !(value & DISPATCH_KIND_MASK) &&
+               _commands[value].registered && _commands[value].name == name;
+    });
+}
+
+// Look up a pulse slot by name (-1 if not registered)
+int Inventronix::findPulse(const char* name, uint32_t nameHash) {
+    int value = _dispatchIndex.find(nameHash, [&](uint16_t value) {
+        return (value & DISPATCH_KIND_MASK) == DISPATCH_PULSE_FLAG &&
+               _pulses[value & DISPATCH_INDEX_MASK]->registered &&
+               _pulses[value & DISPATCH_INDEX_MASK]->name == name;
+    });
+    return (value < 0) ? -1 : (value & DISPATCH_INDEX_MASK);
+}
+
+// Look up a PWM slot by name (-1 if not registered)
+int Inventronix::findPwm(const char* name, uint32_t nameHash) {
+    int value = _dispatchIndex.find(nameHash, [&](uint16_t value) {
+        return (value & DISPATCH_KIND_MASK) == DISPATCH_PWM_FLAG &&
+               _pwm[value & DISPATCH_INDEX_MASK].registered &&
+               _pwm[value & DISPATCH_INDEX_MASK].name == name;
+    });
+    return (value < 0) ? -1 : (value & DISPATCH_INDEX_MASK);
+}
+
+// Look up an output group slot by name (-1 if not registered)
+int Inventronix::findOutputGroup(const char* name, uint32_t nameHash) {
+    int value = _dispatchIndex.find(nameHash, [&](uint16_t value) {
+        return (value & DISPATCH_KIND_MASK) == DISPATCH_GROUP_FLAG &&
+               _groups[value & DISPATCH_INDEX_MASK].registered &&
+               _groups[value & DISPATCH_INDEX_MASK].name == name;
+    });
+    return (value < 0) ? -1 : (value & DISPATCH_INDEX_MASK);
+}
+
+// Switch the group's pins: gather per-port set/clear masks, then write
+// each port once so every pin in it changes on the same clock edge. ESP32
+// has no register that sets and clears together, so GPIO_OUT is read,
+// modified and written back inside the pulse lock, keeping the library's
+// own pin writes out of the gap.
+void Inventronix::applyOutputGroup(OutputGroup& group, uint32_t bits, uint32_t mask) {
+    uint32_t set[INVENTRONIX_OUTPUT_GROUP_MAX_PORTS] = {0};
+    uint32_t clear[INVENTRONIX_OUTPUT_GROUP_MAX_PORTS] = {0};
+
+    uint32_t change = (group.pinCount < 32) ? mask & ((1UL << group.pinCount) - 1) : mask;
+    for (uint32_t pending = change; pending != 0; pending &= pending - 1) {
+        int k = __builtin_ctz(pending);
+        if (bits & (1UL << k)) {
+            set[group.pinPort[k]] |= group.pinMask[k];
+        } else {
+            clear[group.pinPort[k]] |= group.pinMask[k];
+        }
+    }
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+    PULSE_LOCK();
+    for (uint8_t p = 0; p < group.portCount; p++) {
+        if (set[p] | clear[p]) {
+            uint32_t out = REG_READ(group.outRegister[p]);
+            REG_WRITE(group.outRegister[p], (out & ~clear[p]) | set[p]);
+        }
+    }
+    PULSE_UNLOCK();
+#else
+    for (uint8_t p = 0; p < group.portCount; p++) {
+        if (set[p] | clear[p]) *group.outRegister[p] = (clear[p] << 16) | set[p];
+    }
+#endif
+
+    group.state = (group.state & ~change) | (bits & change);
+}
+
+// Check if a pulse command is currently active
+bool Inventronix::isPulsing(const char* commandName) {
+    int i = findPulse(commandName, InventronixDispatchIndex::hash(commandName));
+    return (i >= 0) ? _pulses[i]->state == PULSE_ACTIVE : false;
+}
+
+// Choose how a running pulse handles repeat commands
+bool Inventronix::setPulsePolicy(const char* commandName, PulsePolicy policy,
+                                 uint8_t maxQueued, unsigned long minGapMs) {
+    int i = findPulse(commandName, InventronixDispatchIndex::hash(commandName));
+    if (i < 0) return false;
+    PulseHandler& pulse = *_pulses[i];
+
+    // Restart/extend keep room for one follow-on, used when the off time
+    // can no longer be moved
+    uint8_t limit = (policy == PULSE_QUEUE) ? maxQueued : (policy == PULSE_IGNORE) ? 0 : 1;
+    unsigned long* followOns = nullptr;
+    if (limit > 0) {
+        followOns = (unsigned long*)malloc(limit * sizeof(unsigned long));
+        if (followOns == nullptr) return false;
+    }
+
+    PULSE_LOCK();
+    unsigned long* old = pulse.followOns;
+    pulse.followOns = followOns;
+    pulse.followLimit = limit;
+    pulse.followHead = 0;
+    pulse.followCount = 0;
+    pulse.minGapMs = minGapMs;
+    pulse.policy = policy;
+    PULSE_UNLOCK();
+    free(old);
+    return true;
+}
+
+// How repeat commands for a pulse have been handled so far
+PulseStats Inventronix::pulseStats(const char* commandName) {
+    int i = findPulse(commandName, InventronixDispatchIndex::hash(commandName));
+    return (i >= 0) ? _pulses[i]->stats : PulseStats();
+}
+
+// Process commands from the ingest response
+void Inventronix::processCommands(const String& responseBody) {
+    if (responseBody.length() == 0) return;
+
+    // A handler that calls sendPayload() lands back here while the outer
+    // response is still in use in the parse arena - parse this one on the heap
+    if (_parseDepth > 0) {
+        JsonDocument doc;
+        runCommands(doc, responseBody);
+        return;
+    }
+
+    // Parse into the pre-sized arena - reset, never freed, between responses
+    _parseArena.reset();
+    JsonDocument doc(&_parseArena);
+    runCommands(doc, responseBody);
+}
+
+// Parse a response into `doc` and run or queue its commands
+void Inventronix::runCommands(JsonDocument& doc, const String& responseBody) {
+    DeserializationError error = deserializeJson(doc, responseBody);
+
+    if (error) {
+        if (_debugMode) {
+            logDebug("Failed to parse response JSON: " + String(error.c_str()));
+        }
+        if (error == DeserializationError::NoMemory && _verboseLogging) {
+            Serial.print("⚠️  Response larger than parse arena (");
+            Serial.print(_parseArena.size());
+            Serial.println(" bytes), increase it in begin()");
+        }
+        return;
+    }
+
+    if (_debugMode) {
+        logDebug("Parse arena used: " + String(_parseArena.used()) + "/" + String(_parseArena.size()));
+    }
+
+    // Check for commands array
+    if (!doc["commands"].is<JsonArray>()) {
+        return;  // No commands, that's fine
+    }
+
+    JsonArray commands = doc["commands"].as<JsonArray>();
+    int commandCount = commands.size();
+
+    if (commandCount == 0) return;
+
+    if (_verboseLogging) {
+        Serial.print("📨 Received ");
+        Serial.print(commandCount);
+        Serial.println(" command(s)");
+    }
+
+    _parseDepth++;
+    for (JsonObject cmd : commands) {
+        const char* command = cmd["command"] | "";
+        const char* executionId = cmd["execution_id"] | "";
+        JsonObject args = cmd["arguments"].as<JsonObject>();
+
+        if (strlen(command) > 0) {
+            if (isDuplicateExecution(executionId)) {
+                continue;
+            }
+
+            unsigned long delayMs = 0;
+            if (!commandDelay(cmd, args, delayMs)) {
+                queueAck(executionId, false, "no_server_time");
+                continue;
+            }
+            // Only commands that were accepted are remembered, so a resend
+            // of one dropped for lack of room runs when it arrives again
+            if (delayMs > 0) {
+                if (scheduleCommand(command, args, executionId, delayMs)) {
+                    rememberExecution(executionId);
+                }
+            } else if (_deferredCommands) {
+                if (enqueueCommand(command, args, executionId)) {
+                    rememberExecution(executionId);
+                }
+            } else {
+                rememberExecution(executionId);
+                dispatchCommand(command, args, executionId);
+            }
+        }
+    }
+    _parseDepth--;
+}
+
+// True if this execution_id was accepted recently (a replayed response or
+// a resend after a lost ack). A finished command's ack is sent again with
+// its original outcome; one still waiting to run will ack when it does.
+bool Inventronix::isDuplicateExecution(const char* executionId) {
+    int i = findExecution(executionId, false);
+    if (i < 0) return false;
+
+    _duplicatesSuppressed++;
+    if (_verboseLogging) {
+        Serial.print("   ⏭️  Duplicate execution_id, not running again: ");
+        Serial.println(executionId);
+    }
+
+    // Re-ack so the server stops resending
+    const ExecutionRecord& record = _recentExecutions[i];
+    if (record.finished) {
+        queueAck(executionId, record.success, record.result[0] != '\0' ? record.result : nullptr);
+    }
+    return true;
+}
+
+// Newest cache slot remembering this execution_id, or -1. Finished commands
+// expire after the dedup TTL unless `ignoreTtl`; waiting ones never do.
+int Inventronix::findExecution(const char* executionId, bool ignoreTtl) {
+    if (executionId[0] == '\0') return -1;  // No id - nothing to compare
+
+    uint32_t idHash = InventronixDispatchIndex::hash(executionId);
+    unsigned long now = millis();
+    for (int k = 1; k <= _recentCount; k++) {
+        int i = (_recentNext - k + INVENTRONIX_DEDUP_CACHE_SIZE) % INVENTRONIX_DEDUP_CACHE_SIZE;
+        const ExecutionRecord& record = _recentExecutions[i];
+        if (record.idHash != idHash || !record.live) continue;
+        if (record.finished && !ignoreTtl && _dedupTtl > 0 && now - record.updatedAt >= _dedupTtl) continue;
+        return i;
+    }
+    return -1;
+}
+
+// Remember an accepted command (its outcome follows in completeCommand())
+void Inventronix::rememberExecution(const char* executionId) {
+    if (executionId[0] == '\0') return;
+
+    ExecutionRecord& slot = _recentExecutions[_recentNext];
+    slot.idHash = InventronixDispatchIndex::hash(executionId);
+    slot.updatedAt = millis();
+    slot.live = true;
+    slot.finished = false;
+    slot.success = false;
+    slot.result[0] = '\0';
+    _recentNext = (_recentNext + 1) % INVENTRONIX_DEDUP_CACHE_SIZE;
+    if (_recentCount < INVENTRONIX_DEDUP_CACHE_SIZE) {
+        _recentCount++;
+    }
+}
+
+// An accepted command was dropped before it ran - let a resend through
+void Inventronix::forgetExecution(const char* executionId) {
+    int i = findExecution(executionId, true);
+    if (i >= 0) {
+        _recentExecutions[i].live = false;
+    }
+}
+
+// A command has its outcome: keep it for duplicate re-acks, and ack it
+void Inventronix::completeCommand(const char* executionId, bool success, const char* result) {
+    int i = findExecution(executionId, true);
+    if (i >= 0) {
+        ExecutionRecord& record = _recentExecutions[i];
+        record.finished = true;
+        record.success = success;
+        record.result[0] = '\0';
+        if (result != nullptr) {
+            strncpy(record.result, result, sizeof(record.result) - 1);
+            record.result[sizeof(record.result) - 1] = '\0';
+        }
+        record.updatedAt = millis();
+    }
+    queueAck(executionId, success, result);
+}
+
+// Copy a command out of the parse arena into the next queue slot
+bool Inventronix::enqueueCommand(const char* command, JsonObject args, const char* executionId) {
+    const char* reason = nullptr;
+    if (_queueCount >= INVENTRONIX_COMMAND_QUEUE_DEPTH) {
+        reason = "queue_full";
+    } else {
+        QueuedCommand& slot = _commandQueue[(_queueHead + _queueCount) % INVENTRONIX_COMMAND_QUEUE_DEPTH];
+        reason = copyCommand(slot, command, args, executionId);
+    }
+
+    if (reason != nullptr) {
+        _queueOverflows++;
+        if (_verboseLogging) {
+            Serial.print("⚠️  Command queue overflow (");
+            Serial.print(reason);
+            Serial.print("), dropping: ");
+            Serial.println(command);
+        }
+        queueAck(executionId, false, reason);
+        return false;
+    }
+
+    _queueCount++;
+    if (_debugMode) {
+        logDebug("Queued command: " + String(command));
+    }
+    return true;
+}
+
+// Copy a command into a slot. Returns why it does not fit, or nullptr.
+const char* Inventronix::copyCommand(QueuedCommand& slot, const char* command, JsonObject args,
+                                     const char* executionId) {
+    if (strlen(command) >= INVENTRONIX_COMMAND_NAME_LENGTH) {
+        return "name_too_long";
+    }
+    if (measureJson(args) >= INVENTRONIX_COMMAND_ARGS_SIZE) {
+        return "args_too_large";
+    }
+
+    strcpy(slot.name, command);
+    strncpy(slot.executionId, executionId, sizeof(slot.executionId) - 1);
+    slot.executionId[sizeof(slot.executionId) - 1] = '\0';
+    slot.argsLength = (uint16_t)serializeJson(args, slot.args, sizeof(slot.args));
+    return nullptr;
+}
+
+// Run queued commands until the per-loop budget is spent
+void Inventronix::runQueuedCommands() {
+    unsigned long start = micros();
+
+    while (_queueCount > 0) {
+        dispatchQueued(_commandQueue[_queueHead]);
+
+        _queueHead = (_queueHead + 1) % INVENTRONIX_COMMAND_QUEUE_DEPTH;
+        _queueCount--;
+
+        if (micros() - start >= _commandBudgetUs) {
+            break;
+        }
+    }
+}
+
+// Re-parse a stored command's arguments into the parse arena and run it
+// (on the heap if a handler further up the stack still holds the arena)
+void Inventronix::dispatchQueued(QueuedCommand& slot) {
+    if (_parseDepth > 0) {
+        JsonDocument doc;
+        dispatchStored(doc, slot);
+        return;
+    }
+    _parseArena.reset();
+    JsonDocument doc(&_parseArena);
+    dispatchStored(doc, slot);
+}
+
+// Parse a stored command's arguments into `doc` and run it
+void Inventronix::dispatchStored(JsonDocument& doc, QueuedCommand& slot) {
+    JsonObject args;
+    if (slot.argsLength > 0 && !deserializeJson(doc, slot.args, slot.argsLength)) {
+        args = doc.as<JsonObject>();
+    }
+    _parseDepth++;
+    dispatchCommand(slot.name, args, slot.executionId);
+    _parseDepth--;
+}
+
+// ============================================
+// DEEP-SLEEP DUTY CYCLE
+// ============================================
+
+// Everything a duty cycle must remember between wakes. In RTC memory on
+// ESP32, which survives deep sleep; samples are stored back to back as
+// NUL-terminated JSON objects, oldest first.
+struct DutyCycleState {
+    uint32_t magic;
+    uint32_t cycle;
+    uint32_t nextSeq;
+    uint32_t epochAtSleep;      // Server time when the last cycle slept (0 = unknown)
+    uint32_t sleepMs;
+    uint32_t awakeMs;
+    uint32_t radioMs;
+    uint16_t sampleCount;
+    uint16_t sampleBytes;
+    uint8_t ackCount;
+    CommandAck acks[INVENTRONIX_ACK_BUFFER_SIZE];
+    char samples[INVENTRONIX_DUTY_SAMPLE_BYTES];
+};
+static const uint32_t DUTY_CYCLE_MAGIC = 0x44555459;    // "DUTY"
+RTC_DATA_ATTR static DutyCycleState s_duty;
+
+// Run the duty cycle forever: sample, upload when due, finish commands, sleep
+void Inventronix::runDutyCycle(const char* ssid, const char* password, unsigned long periodMs,
+                               DutyCycleSampleCallback sample, uint8_t uploadEvery) {
+    if (uploadEvery == 0) uploadEvery = 1;
+    _wifiNetworkCount = 0;
+    addWiFiNetwork(ssid, password);
+
+    while (true) {
+        unsigned long cycleStart = millis();
+        restoreDutyCycle();
+        s_duty.cycle++;
+
+        Payload& payload = beginPayload();
+        sample(payload);
+        if (payload.overflowed()) {
+            if (_verboseLogging) {
+                Serial.println("❌ Sample too large for the transmit buffer, skipped");
+            }
+        } else {
+            storeSample(payload.c_str());
+        }
+
+        // One request for every stored sample, then the radio goes off
+        unsigned long radioMs = 0;
+        if (s_duty.sampleCount >= uploadEvery || _ackCount > 0) {
+            unsigned long radioStart = millis();
+            uploadSamples();
+            stopWiFi();
+            radioMs = millis() - radioStart;
+        }
+
+        // Let pulses, deferred and scheduled commands finish
+        unsigned long elapsed;
+        while (dutyWorkPending() && (elapsed = millis() - cycleStart) < INVENTRONIX_DUTY_MAX_AWAKE_MS) {
+            loop();
+            idle(INVENTRONIX_DUTY_MAX_AWAKE_MS - elapsed);
+        }
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+        unsigned long awakeMs = millis();     // Counted from boot, i.e. the wake
+#else
+        unsigned long awakeMs = millis() - cycleStart;
+#endif
+        uint32_t sleepMs = (awakeMs < periodMs) ? periodMs - awakeMs : 0;
+        s_duty.awakeMs = awakeMs;
+        s_duty.radioMs = radioMs;
+        saveDutyCycle(sleepMs);
+
+        if (_verboseLogging) {
+            Serial.print("😴 Cycle ");
+            Serial.print(s_duty.cycle);
+            Serial.print(": awake ");
+            Serial.print(awakeMs);
+            Serial.print("ms, radio ");
+            Serial.print(radioMs);
+            Serial.print("ms, ");
+            Serial.print(s_duty.sampleCount);
+            Serial.print(" sample(s) pending, sleeping ");
+            Serial.print(sleepMs);
+            Serial.println("ms");
+        }
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+        Serial.flush();
+        esp_sleep_enable_timer_wakeup((uint64_t)sleepMs * 1000ULL);
+        esp_deep_sleep_start();
+#else
+        delay(sleepMs);
+#endif
+    }
+}
+
+// Timings of the previous cycle and the samples still waiting
+DutyCycleStats Inventronix::dutyCycleStats() const {
+    DutyCycleStats stats;
+    bool valid = (s_duty.magic == DUTY_CYCLE_MAGIC);
+    stats.cycle = valid ? s_duty.cycle : 0;
+    stats.awakeMs = valid ? s_duty.awakeMs : 0;
+    stats.radioMs = valid ? s_duty.radioMs : 0;
+    stats.pendingSamples = valid ? s_duty.sampleCount : 0;
+    return stats;
+}
+
+// Pick up where the last cycle left off (first power-on starts fresh)
+void Inventronix::restoreDutyCycle() {
+    if (s_duty.magic != DUTY_CYCLE_MAGIC) {
+        memset(&s_duty, 0, sizeof(s_duty));
+        s_duty.magic = DUTY_CYCLE_MAGIC;
+        return;
+    }
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+    // RAM was lost in deep sleep: bring back unsent acks and the server
+    // clock (the time we slept at plus the sleep)
+    _ackHead = 0;
+    _ackCount = s_duty.ackCount;
+    memcpy(_acks, s_duty.acks, sizeof(CommandAck) * _ackCount);
+    if (s_duty.epochAtSleep != 0) {
+        _serverEpochAtSync = s_duty.epochAtSleep + s_duty.sleepMs / 1000;
+        _millisAtSync = 0;
+        _clockSynced = true;
+    }
+#endif
+}
+
+// Save what RAM will lose
+void Inventronix::saveDutyCycle(uint32_t sleepMs) {
+    s_duty.ackCount = (uint8_t)_ackCount;
+    for (int i = 0; i < _ackCount; i++) {
+        s_duty.acks[i] = _acks[(_ackHead + i) % INVENTRONIX_ACK_BUFFER_SIZE];
+    }
+    s_duty.epochAtSleep = serverTime();
+    s_duty.sleepMs = sleepMs;
+}
+
+// Add a sample, tagged with a sequence number and (once known) the server
+// time. When RTC memory is full the oldest samples are dropped.
+void Inventronix::storeSample(const char* json) {
+    char header[48];
+    size_t headerLength = 0;
+    memcpy(header, "{\"_seq\":", 8);
+    headerLength = 8 + InventronixFormat::formatUInt(header + 8, s_duty.nextSeq++);
+    if (hasServerTime()) {
+        memcpy(header + headerLength, ",\"_ts\":", 7);
+        headerLength += 7;
+        headerLength += InventronixFormat::formatUInt(header + headerLength, serverTime());
+    }
+
+    // The sample's own fields follow the header ("{}" adds none)
+    const char* fields = json + 1;
+    while (*fields == ' ' || *fields == '\n' || *fields == '\r' || *fields == '\t') fields++;
+    bool empty = (*fields == '}');
+    size_t fieldsLength = strlen(fields);
+    size_t length = headerLength + (empty ? 1 : 1 + fieldsLength) + 1;    // + NUL
+    if (length > sizeof(s_duty.samples)) return;
+
+    while (s_duty.sampleBytes + length > sizeof(s_duty.samples)) {
+        size_t oldest = strlen(s_duty.samples) + 1;
+        memmove(s_duty.samples, s_duty.samples + oldest, s_duty.sampleBytes - oldest);
+        s_duty.sampleBytes -= oldest;
+        s_duty.sampleCount--;
+        if (_verboseLogging) {
+            Serial.println("⚠️  Sample store full, dropping oldest sample");
+        }
+    }
+
+    char* out = s_duty.samples + s_duty.sampleBytes;
+    memcpy(out, header, headerLength);
+    out += headerLength;
+    if (empty) {
+        *out++ = '}';
+    } else {
+        *out++ = ',';
+        memcpy(out, fields, fieldsLength);
+        out += fieldsLength;
+    }
+    *out = '\0';
+    s_duty.sampleBytes += length;
+    s_duty.sampleCount++;
+}
+
+// Connect (fast, from the WiFi cache) and send every stored sample in one
+// request: the newest as the payload, the previous cycle's timings under
+// "_cycle", older samples under "_samples", and any acks. True if sent.
+bool Inventronix::uploadSamples() {
+    beginWiFi();
+    unsigned long start = millis();
+    while (_wifiState != WIFI_LINK_UP && millis() - start < INVENTRONIX_DUTY_CONNECT_TIMEOUT_MS) {
+        serviceWiFi();
+        delay(1);
+    }
+    if (_wifiState != WIFI_LINK_UP) {
+        if (_verboseLogging) {
+            Serial.println("📴 No WiFi this cycle, keeping samples for the next one");
+        }
+        return false;
+    }
+    if (s_duty.sampleCount == 0) {
+        // Only acks to deliver
+        return sendPayload("{}");
+    }
+
+    size_t ackBytes = (size_t)_ackCount * (INVENTRONIX_EXECUTION_ID_LENGTH + INVENTRONIX_ACK_RESULT_LENGTH + 64);
+    size_t capacity = s_duty.sampleBytes + ackBytes + 160;
+    char* body = (char*)malloc(capacity);
+    if (body == nullptr) return false;
+
+    // Newest sample, re-opened
+    const char* newest = s_duty.samples;
+    for (uint16_t i = 1; i < s_duty.sampleCount; i++) {
+        newest += strlen(newest) + 1;
+    }
+    size_t pos = strlen(newest) - 1;
+    memcpy(body, newest, pos);
+
+    if (s_duty.cycle > 1) {
+        static const char CYCLE_KEY[] = ",\"" INVENTRONIX_CYCLE_FIELD "\":{\"awake_ms\":";
+        memcpy(body + pos, CYCLE_KEY, sizeof(CYCLE_KEY) - 1);
+        pos += sizeof(CYCLE_KEY) - 1;
+        pos += InventronixFormat::formatUInt(body + pos, s_duty.awakeMs);
+        memcpy(body + pos, ",\"radio_ms\":", 12);
+        pos += 12;
+        pos += InventronixFormat::formatUInt(body + pos, s_duty.radioMs);
+        body[pos++] = '}';
+    }
+
+    if (s_duty.sampleCount > 1) {
+        static const char SAMPLES_KEY[] = ",\"" INVENTRONIX_SAMPLES_FIELD "\":[";
+        memcpy(body + pos, SAMPLES_KEY, sizeof(SAMPLES_KEY) - 1);
+        pos += sizeof(SAMPLES_KEY) - 1;
+        const char* sample = s_duty.samples;
+        for (uint16_t i = 0; i + 1 < s_duty.sampleCount; i++) {
+            if (i > 0) body[pos++] = ',';
+            size_t length = strlen(sample);
+            memcpy(body + pos, sample, length);
+            pos += length;
+            sample += length + 1;
+        }
+        body[pos++] = ']';
+    }
+
+    int acksAttached = 0;
+    char* ackStart = nullptr;
+    if (_commandAcks && _ackCount > 0) {
+        static const char ACK_KEY[] = ",\"" INVENTRONIX_ACK_FIELD "\":[";
+        ackStart = body + pos;
+        memcpy(body + pos, ACK_KEY, sizeof(ACK_KEY) - 1);
+        pos += sizeof(ACK_KEY) - 1;
+        pos += writeAcks(body + pos, capacity - pos - 3, acksAttached);
+        body[pos++] = ']';
+    }
+    body[pos++] = '}';
+    body[pos] = '\0';
+
+    bool sent = postIngest(body, acksAttached, ackStart);
+    free(body);
+    if (sent) {
+        s_duty.sampleCount = 0;
+        s_duty.sampleBytes = 0;
+    }
+    return sent;
+}
+
+// Anything left that needs the CPU awake?
+bool Inventronix::dutyWorkPending() {
+    bool pending = _queueCount > 0 || _scheduler.count() > 0 || !_pulseQueue.empty() ||
+                   !_pulseEvents.empty() || !_pwmQueue.empty();
+#ifdef INVENTRONIX_PRECISION_GPT
+    pending = pending || !_precisionQueue.empty();
+#endif
+    return pending;
+}
+
+// Stop managing WiFi and switch the radio off
+void Inventronix::stopWiFi() {
+    _wifiManaged = false;
+    setWiFiState(WIFI_LINK_OFF);
+#ifdef INVENTRONIX_PLATFORM_ESP
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+#else
+    WiFi.end();
+#endif
+}
+
+// ============================================
+// SCHEDULED COMMANDS
+// ============================================
+
+// How long to wait before running a command, from "delay_ms" or
+// "execute_at" (Unix seconds or milliseconds) on the command or in its
+// arguments. Returns false if execute_at is set but server time is unknown.
+bool Inventronix::commandDelay(JsonObject cmd, JsonObject args, unsigned long& delayMs) {
+    delayMs = cmd["delay_ms"] | 0UL;
+    if (delayMs == 0) {
+        delayMs = args["delay_ms"] | 0UL;
+    }
+    if (delayMs > 0) return true;
+
+    double executeAt = cmd["execute_at"] | 0.0;
+    if (executeAt <= 0) {
+        executeAt = args["execute_at"] | 0.0;
+    }
+    if (executeAt <= 0) return true;
+    if (!_clockSynced) return false;
+
+    // Values this large are already milliseconds
+    int64_t targetMs = (executeAt > 1e11) ? (int64_t)executeAt : (int64_t)(executeAt * 1000.0);
+    int64_t nowMs = (int64_t)_serverEpochAtSync * 1000 + (int64_t)(millis() - _millisAtSync);
+    int64_t wait = targetMs - nowMs;
+    delayMs = (wait > 0) ? (unsigned long)wait : 0;
+    return true;
+}
+
+// Park a command on the timer wheel until its time comes
+bool Inventronix::scheduleCommand(const char* command, JsonObject args, const char* executionId,
+                                  unsigned long delayMs) {
+    uint32_t idHash = InventronixDispatchIndex::hash(executionId);
+    int slot = _scheduler.schedule(idHash, delayMs, millis());
+
+    const char* reason = (slot < 0) ? "schedule_full"
+                                    : copyCommand(_scheduledCommands[slot], command, args, executionId);
+    if (reason != nullptr) {
+        if (slot >= 0) {
+            _scheduler.cancel(slot);
+        }
+        _queueOverflows++;
+        if (_verboseLogging) {
+            Serial.print("⚠️  Cannot schedule command (");
+            Serial.print(reason);
+            Serial.print("), dropping: ");
+            Serial.println(command);
+        }
+        queueAck(executionId, false, reason);
+        return false;
+    }
+
+    if (_verboseLogging) {
+        Serial.print("⏰ Scheduled ");
+        Serial.print(command);
+        Serial.print(" in ");
+        Serial.print(delayMs);
+        Serial.println("ms");
+    }
+    return true;
+}
+
+// Timer wheel callback - the slot has already left the wheel
+void Inventronix::runScheduledCommand(int slot) {
+    QueuedCommand& scheduled = _scheduledCommands[slot];
+    if (_deferredCommands) {
+        // Join the deferred queue so it shares the loop() budget
+        if (_queueCount < INVENTRONIX_COMMAND_QUEUE_DEPTH) {
+            _commandQueue[(_queueHead + _queueCount) % INVENTRONIX_COMMAND_QUEUE_DEPTH] = scheduled;
+            _queueCount++;
+            return;
+        }
+        _queueOverflows++;
+        forgetExecution(scheduled.executionId);
+        queueAck(scheduled.executionId, false, "queue_full");
+        return;
+    }
+    dispatchQueued(scheduled);
+}
+
+// Commands waiting for their time
+int Inventronix::scheduledCommandCount() const {
+    return _scheduler.count();
+}
+
+// Report every pending scheduled command
+void Inventronix::listScheduledCommands(ScheduledCommandCallback callback) {
+    unsigned long now = millis();
+    for (int i = 0; i < INVENTRONIX_MAX_SCHEDULED_COMMANDS; i++) {
+        if (_scheduler.pending(i)) {
+            callback(_scheduledCommands[i].name, _scheduledCommands[i].executionId,
+                     _scheduler.remainingMs(i, now));
+        }
+    }
+}
+
+// Cancel a pending scheduled command by execution_id
+bool Inventronix::cancelScheduledCommand(const char* executionId) {
+    int slot = _scheduler.find(InventronixDispatchIndex::hash(executionId), [&](int i) {
+        return strcmp(_scheduledCommands[i].executionId, executionId) == 0;
+    });
+    if (slot < 0) return false;
+
+    _scheduler.cancel(slot);
+    completeCommand(executionId, false, "cancelled");
+    if (_verboseLogging) {
+        Serial.print("🚫 Cancelled scheduled command: ");
+        Serial.println(_scheduledCommands[slot].name);
+    }
+    return true;
+}
+
+// True once a response has told us the server's time
+bool Inventronix::hasServerTime() const {
+    return _clockSynced;
+}
+
+// Current server time in Unix seconds
+uint32_t Inventronix::serverTime() const {
+    if (!_clockSynced) return 0;
+    return _serverEpochAtSync + (millis() - _millisAtSync) / 1000;
+}
+
+// Learn the server clock from an HTTP Date header ("Sun, 06 Nov 1994 08:49:37 GMT")
+void Inventronix::syncServerClock(const char* httpDate) {
+    static const char MONTHS[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+    const char* p = strchr(httpDate, ',');
+    if (p == nullptr) return;
+    int day, year, hour, minute, second;
+    char monthName[4] = {0};
+    if (sscanf(p + 1, " %d %3s %d %d:%d:%d", &day, monthName, &year, &hour, &minute, &second) != 6) {
+        return;
+    }
+    const char* found = strstr(MONTHS, monthName);
+    if (found == nullptr || (found - MONTHS) % 3 != 0) return;
+    int month = (int)(found - MONTHS) / 3 + 1;
+
+    // Days since 1970-01-01 (Howard Hinnant's days_from_civil)
+    int y = year - (month <= 2 ? 1 : 0);
+    int era = y / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    long days = (long)era * 146097 + doe - 719468;
+
+    _serverEpochAtSync = (uint32_t)(days * 86400L + hour * 3600L + minute * 60L + second);
+    _millisAtSync = millis();
+    _clockSynced = true;
+}
+
+// Dispatch a command to the appropriate handler
+void Inventronix::dispatchCommand(const char* command, JsonObject args, const char* executionId) {
+    if (_verboseLogging) {
+        Serial.print("⚡ Dispatching command: ");
+        Serial.println(command);
+    }
+
+    uint32_t nameHash = InventronixDispatchIndex::hash(command);
+
+    // Check toggle commands first
+    int i = findCommand(command, nameHash);
+    if (i >= 0) {
+        if (_debugMode) {
+            logDebug("Matched toggle command handler");
+        }
+
+        // Handlers may report failure or a result via setCommandResult()
+        _resultSuccess = true;
+        _resultValue = nullptr;
+        _commands[i].callback(args);
+        completeCommand(executionId, _resultSuccess, _resultValue);
+        _resultValue = nullptr;
+        return;
+    }
+
+    // Check pulse commands
+    i = findPulse(command, nameHash);
+    if (i >= 0) {
+        PulseHandler& pulse = *_pulses[i];
+
+        // Determine duration: use registered value, or pull from args
+        unsigned long duration = pulse.durationMs;
+        if (duration == 0) {
+            // Try to get from command arguments
+            duration = args["duration"] | args["duration_ms"] | 0UL;
+            if (duration == 0) {
+                if (_verboseLogging) {
+                    Serial.println("   ❌ No duration specified (set in onPulse or send in args)");
+                }
+                completeCommand(executionId, false, "no_duration");
+                return;
+            }
+        }
+
+        const char* failure = beginPulse(i, duration);
+        if (failure != nullptr) {
+            completeCommand(executionId, false, failure);
+            return;
+        }
+
+        completeCommand(executionId, true, nullptr);
+        return;
+    }
 
-    if (_verboseLogging) {
-        Serial.print("📝 Registered pulse command: " + String(commandName));
-        Serial.print(" (pin ");
-        Serial.print(pin);
-        if (durationMs > 0) {
-            Serial.print(", ");
-            Serial.print(durationMs);
-            Serial.print("ms");
+    // Check PWM commands
+    i = findPwm(command, nameHash);
+    if (i >= 0) {
+        const char* failure = dispatchPwm(i, args);
+        completeCommand(executionId, failure == nullptr, failure);
+        return;
+    }
+
+    // Check output groups
+    i = findOutputGroup(command, nameHash);
+    if (i >= 0) {
+        OutputGroup& group = _groups[i];
+        uint32_t bits = 0;
+        uint32_t mask = args["mask"] | 0xFFFFFFFFUL;
+
+        // "bits": 5 (bit i = pins[i]), or "states": [1, 0, 1, ...]
+        JsonArray states = args["states"];
+        if (!states.isNull()) {
+            mask &= (states.size() >= 32) ? 0xFFFFFFFFUL : (1UL << states.size()) - 1;
+            int k = 0;
+            for (JsonVariant state : states) {
+                if (k >= 32) break;
+                if (state.as<bool>()) bits |= 1UL << k;
+                k++;
+            }
+        } else if (!args["bits"].isNull()) {
+            bits = args["bits"] | 0UL;
         } else {
-            Serial.print(", duration from args");
+            completeCommand(executionId, false, "no_state");
+            return;
         }
-        Serial.println(")");
-    }
-}
 
-// Register a pulse command - callback-based version
-void Inventronix::onPulse(const char* commandName, unsigned long durationMs,
-                          PulseOnCallback onCb, PulseOffCallback offCb) {
-    if (_pulseCount >= INVENTRONIX_MAX_PULSES) {
+        applyOutputGroup(group, bits, mask);
         if (_verboseLogging) {
-            Serial.println("⚠️  Max pulse commands registered, ignoring: " + String(commandName));
+            Serial.print("🔀 Output group ");
+            Serial.print(group.name);
+            Serial.print(" = 0x");
+            Serial.println(group.state, HEX);
         }
+        completeCommand(executionId, true, nullptr);
         return;
     }
 
-    _pulses[_pulseCount].name = String(commandName);
-    _pulses[_pulseCount].pin = -1;  // Using callbacks, not direct pin
-    _pulses[_pulseCount].durationMs = durationMs;
-    _pulses[_pulseCount].onCallback = onCb;
-    _pulses[_pulseCount].offCallback = offCb;
-    _pulses[_pulseCount].active = false;
-    _pulses[_pulseCount].registered = true;
-    _pulseCount++;
-
+    // No handler found
     if (_verboseLogging) {
-        Serial.print("📝 Registered pulse command: " + String(commandName));
-        Serial.print(" (callback, ");
-        if (durationMs > 0) {
-            Serial.print(durationMs);
-            Serial.print("ms");
-        } else {
-            Serial.print("duration from args");
-        }
-        Serial.println(")");
+        Serial.print("   ⚠️  No handler registered for command: ");
+        Serial.println(command);
     }
+    forgetExecution(executionId);
+    queueAck(executionId, false, "no_handler");
 }
 
-// Check if a pulse command is currently active
-bool Inventronix::isPulsing(const char* commandName) {
-    for (int i = 0; i < _pulseCount; i++) {
-        if (_pulses[i].registered && _pulses[i].name == commandName) {
-            return _pulses[i].active;
+// Load a PWM command's duty / ramp / steps and start it. Returns why it was
+// rejected, or nullptr. A new command replaces whatever the output was doing.
+const char* Inventronix::dispatchPwm(int index, JsonObject args) {
+    PwmHandler& pwm = _pwm[index];
+    PwmStep steps[INVENTRONIX_PWM_MAX_STEPS];
+    int stepCount = 0;
+    unsigned long cycleMs = 0;
+
+    JsonArray list = args["steps"];
+    if (!list.isNull()) {
+        // Waveform: [{"duty": 80, "ramp_ms": 500, "hold_ms": 2000}, ...]
+        if (list.size() == 0 || list.size() > INVENTRONIX_PWM_MAX_STEPS) return "bad_steps";
+        for (JsonObject step : list) {
+            float duty = step["duty"] | -1.0f;
+            if (duty < 0.0f || duty > 100.0f) return "bad_duty";
+            steps[stepCount].duty = (uint16_t)(duty * 100.0f + 0.5f);
+            steps[stepCount].rampMs = step["ramp_ms"] | 0UL;
+            steps[stepCount].holdMs = step["hold_ms"] | 0UL;
+            cycleMs += steps[stepCount].rampMs + steps[stepCount].holdMs;
+            stepCount++;
         }
+    } else if (!args["duty"].isNull()) {
+        float duty = args["duty"] | -1.0f;
+        if (duty < 0.0f || duty > 100.0f) return "bad_duty";
+        steps[0].duty = (uint16_t)(duty * 100.0f + 0.5f);
+        steps[0].rampMs = args["ramp_ms"] | pwm.defaultRampMs;
+        steps[0].holdMs = 0;
+        stepCount = 1;
     }
-    return false;
+
+    // "repeat": runs of the step list (0 = until the next command)
+    int repeat = args["repeat"] | 1;
+    if (repeat < 0 || (repeat != 1 && cycleMs == 0)) return "bad_steps";
+
+    uint32_t frequency = args["frequency"] | 0UL;
+    if (stepCount == 0 && frequency == 0) return "no_duty";
+
+    if (frequency > 0 && frequency != pwm.frequencyHz) {
+        setPwmFrequency(pwm, frequency);
+    }
+    if (stepCount == 0) return nullptr;
+
+    memcpy(pwm.steps, steps, stepCount * sizeof(PwmStep));
+    pwm.stepCount = (uint8_t)stepCount;
+    pwm.stepIndex = 0;
+    pwm.repeatsLeft = (repeat == 0) ? PWM_REPEAT_FOREVER : (uint16_t)(repeat - 1);
+    _pwmQueue.cancel(index);
+
+    if (_verboseLogging) {
+        Serial.print("🎚️  PWM ");
+        Serial.print(pwm.name);
+        Serial.print(": ");
+        Serial.print(stepCount);
+        Serial.println(stepCount == 1 ? " step" : " steps");
+    }
+
+    startPwmStep(index);
+    return nullptr;
 }
 
-// Process commands from the ingest response
-void Inventronix::processCommands(const String& responseBody) {
-    if (responseBody.length() == 0) return;
+// Begin the current step: ramp towards its duty, or jump straight there
+void Inventronix::startPwmStep(int index) {
+    PwmHandler& pwm = _pwm[index];
+    const PwmStep& step = pwm.steps[pwm.stepIndex];
 
-    JsonDocument doc;
-    DeserializationError error = deserializeJson(doc, responseBody);
+    if (step.rampMs > 0 && step.duty != pwm.duty) {
+        pwm.rampFrom = pwm.duty;
+        pwm.rampStart = millis();
+        pwm.ramping = true;
+        _pwmQueue.schedule(index, (uint32_t)(pwm.rampStart + INVENTRONIX_RAMP_UPDATE_MS));
+        return;
+    }
 
-    if (error) {
-        if (_debugMode) {
-            logDebug("Failed to parse response JSON: " + String(error.c_str()));
+    writePwm(pwm, step.duty);
+    holdPwmStep(index);
+}
+
+// Hold the current step's duty, then move to the next step (if any)
+void Inventronix::holdPwmStep(int index) {
+    PwmHandler& pwm = _pwm[index];
+    pwm.ramping = false;
+
+    bool lastStep = (pwm.stepIndex + 1 >= pwm.stepCount);
+    if (lastStep && pwm.repeatsLeft == 0) return;   // Stay at this duty
+
+    _pwmQueue.schedule(index, (uint32_t)(millis() + pwm.steps[pwm.stepIndex].holdMs));
+}
+
+// Advance ramps and step lists that are due. Only the earliest entry is
+// examined when nothing is due.
+void Inventronix::servicePwm() {
+    uint32_t now = millis();
+    int i;
+    while ((i = _pwmQueue.popDue(now)) >= 0) {
+        PwmHandler& pwm = _pwm[i];
+        const PwmStep& step = pwm.steps[pwm.stepIndex];
+
+        if (pwm.ramping) {
+            // Interpolate from the time elapsed, so a late update catches up
+            unsigned long elapsed = now - pwm.rampStart;
+            if (elapsed < step.rampMs) {
+                // 64-bit: span (up to 10000) times a long ramp overflows a long
+                int64_t span = (int64_t)step.duty - (int64_t)pwm.rampFrom;
+                writePwm(pwm, (uint16_t)(pwm.rampFrom + span * (int64_t)elapsed / (int64_t)step.rampMs));
+                _pwmQueue.schedule(i, now + INVENTRONIX_RAMP_UPDATE_MS);
+                continue;
+            }
+            writePwm(pwm, step.duty);
+            holdPwmStep(i);
+            continue;
         }
-        return;
+
+        // Hold finished - next step, or back to the first for another run
+        pwm.stepIndex++;
+        if (pwm.stepIndex >= pwm.stepCount) {
+            pwm.stepIndex = 0;
+            if (pwm.repeatsLeft != PWM_REPEAT_FOREVER) {
+                pwm.repeatsLeft--;
+            }
+        }
+        startPwmStep(i);
     }
+}
 
-    // Check for commands array
-    if (!doc["commands"].is<JsonArray>()) {
-        return;  // No commands, that's fine
+// Set the hardware duty (hundredths of a percent)
+void Inventronix::writePwm(PwmHandler& pwm, uint16_t duty) {
+#ifdef INVENTRONIX_PLATFORM_ESP
+    uint32_t raw = (uint32_t)duty * ((1UL << INVENTRONIX_PWM_RESOLUTION) - 1) / 10000;
+#ifdef INVENTRONIX_LEDC_PIN_API
+    ledcWrite(pwm.pin, raw);
+#else
+    ledcWrite(pwm.channel, raw);
+#endif
+#else
+    pwm.output->pulse_perc(duty / 100.0f);
+#endif
+    pwm.duty = duty;
+}
+
+// Change the PWM frequency, keeping the duty
+void Inventronix::setPwmFrequency(PwmHandler& pwm, uint32_t frequencyHz) {
+#if defined(INVENTRONIX_LEDC_PIN_API)
+    ledcChangeFrequency(pwm.pin, frequencyHz, INVENTRONIX_PWM_RESOLUTION);
+#elif defined(INVENTRONIX_PLATFORM_ESP)
+    ledcChangeFrequency(pwm.channel, frequencyHz, INVENTRONIX_PWM_RESOLUTION);
+#else
+    pwm.output->end();
+    pwm.output->begin((float)frequencyHz, pwm.duty / 100.0f);
+#endif
+    pwm.frequencyHz = frequencyHz;
+}
+
+// Start pulse `index` for `durationMs`. Returns why it did not start, or nullptr.
+const char* Inventronix::beginPulse(int index, unsigned long durationMs) {
+    PulseHandler& pulse = *_pulses[index];
+
+    if (pulse.precision && durationMs > INVENTRONIX_PRECISION_PULSE_MAX_MS) {
+        if (_verboseLogging) {
+            Serial.println("   ❌ Duration too long for a precision pulse");
+        }
+        return "too_long";
     }
 
-    JsonArray commands = doc["commands"].as<JsonArray>();
-    int commandCount = commands.size();
+    // Finish whatever the pulse timer has handed over, so a pulse that has
+    // just ended runs its off callback before it starts again
+    processPulseEvents();
 
-    if (commandCount == 0) return;
+    // Already running (or waiting out a gap) - the pulse's policy decides
+    if (pulse.state != PULSE_IDLE) {
+        return repeatPulse(index, durationMs);
+    }
 
     if (_verboseLogging) {
-        Serial.print("📨 Received ");
-        Serial.print(commandCount);
-        Serial.println(" command(s)");
+        Serial.print("🔄 Pulsing for ");
+        Serial.print(durationMs);
+        Serial.println("ms");
     }
 
-    for (JsonObject cmd : commands) {
-        const char* command = cmd["command"] | "";
-        const char* executionId = cmd["execution_id"] | "";
-        JsonObject args = cmd["arguments"].as<JsonObject>();
+    if (!startPulseOutput(index, durationMs)) {
+        return "hardware_busy";
+    }
+    return nullptr;
+}
 
-        if (strlen(command) > 0) {
-            dispatchCommand(command, args, executionId);
+// Apply the repeat policy to a pulse that is already running
+const char* Inventronix::repeatPulse(int index, unsigned long durationMs) {
+    PulseHandler& pulse = *_pulses[index];
+
+    if (pulse.policy == PULSE_IGNORE) {
+        pulse.stats.dropped++;
+        if (_verboseLogging) {
+            Serial.println("   ⏭️  Already pulsing, ignoring");
         }
+        return "already_pulsing";
+    }
+
+    // Restart/extend move the off time when they can; otherwise (and for
+    // PULSE_QUEUE) the request becomes a follow-on pulse
+    bool adjusted = false;
+    bool queued = false;
+    PULSE_LOCK();
+    if (pulse.policy != PULSE_QUEUE && pulse.state != PULSE_WAITING) {
+        adjusted = adjustPulse(index, durationMs);
+    }
+    if (!adjusted) {
+        queued = pushFollowOn(pulse, durationMs);
+    }
+    PULSE_UNLOCK();
+#ifdef INVENTRONIX_PLATFORM_ESP
+    if (adjusted) {
+        armPulseTimer();
+    }
+#endif
+
+    if (!adjusted && !queued) {
+        pulse.stats.dropped++;
+        if (_verboseLogging) {
+            Serial.println("   ⏭️  Pulse queue full, ignoring");
+        }
+        return "queue_full";
+    }
+
+    if (pulse.policy == PULSE_RESTART) {
+        pulse.stats.restarted++;
+    } else if (pulse.policy == PULSE_EXTEND) {
+        pulse.stats.extended++;
+    } else {
+        pulse.stats.queued++;
     }
-}
 
-// Dispatch a command to the appropriate handler
-void Inventronix::dispatchCommand(const char* command, JsonObject args, const char* executionId) {
     if (_verboseLogging) {
-        Serial.print("⚡ Dispatching command: ");
-        Serial.println(command);
+        Serial.print(pulse.policy == PULSE_RESTART ? "🔁 Pulse restarted for " :
+                     pulse.policy == PULSE_EXTEND ? "➕ Pulse extended by " : "📥 Pulse queued for ");
+        Serial.print(durationMs);
+        Serial.println("ms");
     }
+    return nullptr;
+}
 
-    // Check toggle commands first
-    for (int i = 0; i < _commandCount; i++) {
-        if (_commands[i].registered && _commands[i].name == command) {
-            if (_debugMode) {
-                logDebug("Matched toggle command handler");
-            }
-            _commands[i].callback(args);
+// Move the off time of a running pulse (lock held). False if it cannot be
+// moved - its off is already being handled, or the waveform is in hardware.
+bool Inventronix::adjustPulse(int index, unsigned long durationMs) {
+    PulseHandler& pulse = *_pulses[index];
+    InventronixPulseHeap* queue = &_pulseQueue;
+    uint32_t now = millis();
+    uint32_t amount = durationMs;
+
+#if defined(INVENTRONIX_PRECISION_RMT)
+    if (pulse.precision) return false;
+#elif defined(INVENTRONIX_PRECISION_GPT)
+    if (pulse.precision) {
+        queue = &_precisionQueue;
+        now = micros();
+        amount = durationMs * 1000UL;
+    }
+#endif
 
-            // TODO: Send ack to server when endpoint exists
-            // ackExecution(executionId, true);
-            return;
+    if (!queue->contains(index)) return false;
+
+    uint32_t deadline = (pulse.policy == PULSE_EXTEND) ? queue->deadlineOf(index) + amount
+                                                       : now + amount;
+    if (pulse.precision && deadline - now > INVENTRONIX_PRECISION_PULSE_MAX_MS * 1000UL) {
+        return false;
+    }
+    queue->schedule(index, deadline);
+
+#ifdef INVENTRONIX_PRECISION_GPT
+    if (pulse.precision) {
+        armPrecisionTimer();
+    }
+#endif
+    return true;
+}
+
+// Drive the output on and queue its off time (loop() context)
+bool Inventronix::startPulseOutput(int index, unsigned long durationMs) {
+    PulseHandler& pulse = *_pulses[index];
+
+#if defined(INVENTRONIX_PRECISION_RMT)
+    if (pulse.precision) {
+        // RMT drives both edges; the pulse timer only clears the state afterwards
+        if (!writePrecisionPulse(pulse, durationMs)) {
+            pulse.state = PULSE_IDLE;
+            return false;
         }
+        PULSE_LOCK();
+        pulse.state = PULSE_ACTIVE;
+        _pulseQueue.schedule(index, (uint32_t)(millis() + durationMs + 1));
+        PULSE_UNLOCK();
+        armPulseTimer();
+        return true;
+    }
+#elif defined(INVENTRONIX_PRECISION_GPT)
+    if (pulse.precision) {
+        // Rising edge and timer start together, so the width is the timer period
+        PULSE_LOCK();
+        pulse.state = PULSE_ACTIVE;
+        digitalWrite(pulse.pin, HIGH);
+        _precisionQueue.schedule(index, (uint32_t)(micros() + durationMs * 1000UL));
+        armPrecisionTimer();
+        PULSE_UNLOCK();
+        return true;
+    }
+#endif
+
+    // Callbacks run here, never in the timer
+    if (pulse.pin < 0 && pulse.onCallback) {
+        pulse.onCallback();
     }
 
-    // Check pulse commands
-    for (int i = 0; i < _pulseCount; i++) {
-        if (_pulses[i].registered && _pulses[i].name == command) {
-            // Ignore if already pulsing (spam protection)
-            if (_pulses[i].active) {
-                if (_verboseLogging) {
-                    Serial.println("   ⏭️  Already pulsing, ignoring");
-                }
-                return;
-            }
+    // Rising edge and off time together, so the timer cannot end the pulse
+    // between them; the pulse timer is re-armed for the earliest off time
+    PULSE_LOCK();
+    pulse.state = PULSE_ACTIVE;
+    if (pulse.pin >= 0) {
+        digitalWrite(pulse.pin, HIGH);
+    }
+    _pulseQueue.schedule(index, (uint32_t)(millis() + durationMs));
+    PULSE_UNLOCK();
+#ifdef INVENTRONIX_PLATFORM_ESP
+    armPulseTimer();
+#endif
+    return true;
+}
 
-            // Determine duration: use registered value, or pull from args
-            unsigned long duration = _pulses[i].durationMs;
-            if (duration == 0) {
-                // Try to get from command arguments
-                duration = args["duration"] | args["duration_ms"] | 0UL;
-                if (duration == 0) {
-                    if (_verboseLogging) {
-                        Serial.println("   ❌ No duration specified (set in onPulse or send in args)");
-                    }
-                    return;
-                }
+// Follow-on ring (lock held)
+bool Inventronix::pushFollowOn(PulseHandler& pulse, unsigned long durationMs) {
+    if (pulse.followCount >= pulse.followLimit) return false;
+    pulse.followOns[(pulse.followHead + pulse.followCount) % pulse.followLimit] = durationMs;
+    pulse.followCount++;
+    return true;
+}
+
+unsigned long Inventronix::popFollowOn(PulseHandler& pulse) {
+    if (pulse.followCount == 0) return 0;
+    unsigned long durationMs = pulse.followOns[pulse.followHead];
+    pulse.followHead = (pulse.followHead + 1) % pulse.followLimit;
+    pulse.followCount--;
+    return durationMs;
+}
+
+// End every pulse whose off time has passed. Only the head of the queue is
+// examined, so this costs O(1) when nothing is due, however many pulses exist.
+// On ESP this is the pulse timer: pin edges are written here, and anything
+// that may call user code or Serial is handed to loop() as a PulseEvent.
+// Returns false if it stopped early because the event queue is full.
+bool Inventronix::servicePulses() {
+    while (true) {
+        uint32_t now = millis();
+
+        PULSE_LOCK();
+        // Each pass pushes at most two events; leave due pulses queued until
+        // loop() has drained some
+        if (_pulseEvents.space() < 2) {
+            PULSE_UNLOCK();
+            return false;
+        }
+        int i = _pulseQueue.popDue(now);
+        if (i < 0) {
+            PULSE_UNLOCK();
+            return true;
+        }
+        PulseHandler& pulse = *_pulses[i];
+
+        // An off time, or the end of the gap before a follow-on pulse
+        bool ending = (pulse.state != PULSE_WAITING);
+        uint8_t state = PULSE_IDLE;
+        unsigned long next = 0;
+        if (pulse.followCount > 0) {
+            if (ending && pulse.minGapMs > 0) {
+                state = PULSE_WAITING;
+                _pulseQueue.schedule(i, now + pulse.minGapMs);
+            } else {
+                state = PULSE_ACTIVE;
+                next = popFollowOn(pulse);
             }
+        }
 
-            if (_verboseLogging) {
-                Serial.print("🔄 Pulsing for ");
-                Serial.print(duration);
-                Serial.println("ms");
+        // Plain pin pulses are handled completely here; callback and RMT
+        // pulses restart from loop()
+        bool direct = (pulse.pin >= 0 && !pulse.precision);
+        if (ending) {
+            if (direct) {
+                digitalWrite(pulse.pin, LOW);
+            }
+            if (pulse.pin < 0) {
+                _pulseEvents.push({(uint16_t)i, PULSE_EVENT_OFF, 0});
+            } else if (_verboseLogging) {
+                _pulseEvents.push({(uint16_t)i, PULSE_EVENT_ENDED, 0});
             }
+        }
+        if (next > 0) {
+            if (direct) {
+                digitalWrite(pulse.pin, HIGH);
+                _pulseQueue.schedule(i, now + next);
+            } else {
+                _pulseEvents.push({(uint16_t)i, PULSE_EVENT_START, next});
+            }
+        }
+        pulse.state = state;
+        PULSE_UNLOCK();
+    }
+}
 
-            // Start the pulse
-            _pulses[i].active = true;
+// Run the work the pulse timer handed over: off callbacks, follow-on
+// starts that need loop(), and completion logging
+void Inventronix::processPulseEvents() {
+    PulseEvent event;
+    while (_pulseEvents.pop(event)) {
+        PulseHandler& pulse = *_pulses[event.index];
 
-            if (_pulses[i].pin >= 0) {
-                // Pin-based pulse
-                digitalWrite(_pulses[i].pin, HIGH);
-            } else if (_pulses[i].onCallback) {
-                // Callback-based pulse
-                _pulses[i].onCallback();
-            }
+        if (event.type == PULSE_EVENT_START) {
+            startPulseOutput(event.index, event.durationMs);
+            continue;
+        }
+
+        if (_verboseLogging) {
+            Serial.print("⏹️  Pulse complete: ");
+            Serial.println(pulse.name);
+        }
+        if (event.type == PULSE_EVENT_OFF && pulse.offCallback) {
+            pulse.offCallback();
+        }
+    }
+}
 
 #ifdef INVENTRONIX_PLATFORM_ESP
-            // Schedule the off using Ticker with static callback
-            _pulses[i].ticker.once_ms(duration, pulseOffCallback, i);
-#else
-            // Store timing for millis-based check in loop()
-            _pulses[i].startTime = millis();
-            _pulses[i].activeDuration = duration;
+// Arm the single pulse timer for the earliest off time, no sooner than
+// `minDelayUs` from now
+void Inventronix::armPulseTimer(uint32_t minDelayUs) {
+    PULSE_LOCK();
+    esp_timer_stop(_pulseTimer);
+    if (!_pulseQueue.empty()) {
+        int32_t wait = (int32_t)(_pulseQueue.topDeadline() - (uint32_t)millis());
+        uint64_t delayUs = (wait > 0) ? (uint64_t)wait * 1000 : 1;
+        if (delayUs < minDelayUs) delayUs = minDelayUs;
+        esp_timer_start_once(_pulseTimer, delayUs);
+    }
+    PULSE_UNLOCK();
+}
+
+// esp_timer callback - end due pulses, then wait for the next one. Kept
+// short: no Serial and no user callbacks. If loop() has fallen behind on
+// events, try again in a millisecond rather than spinning.
+void Inventronix::pulseTimerCallback(void* arg) {
+    Inventronix* self = static_cast<Inventronix*>(arg);
+    bool drained = self->servicePulses();
+    self->armPulseTimer(drained ? 1 : 1000);
+    if (!self->_pulseEvents.empty()) {
+        self->wakeIdle();
+    }
+}
 #endif
 
-            // TODO: Send ack to server when endpoint exists
-            // ackExecution(executionId, true);
-            return;
+#ifdef INVENTRONIX_PRECISION_RMT
+// Encode a HIGH pulse of `durationMs` as RMT symbols and start it. The
+// waveform buffer must outlive the transmission, so it belongs to the pulse.
+bool Inventronix::writePrecisionPulse(PulseHandler& pulse, unsigned long durationMs) {
+    uint32_t remaining = durationMs * (RMT_RESOLUTION_HZ / 1000);
+    size_t highHalves = (remaining + RMT_MAX_HALF_US - 1) / RMT_MAX_HALF_US;
+    size_t count = (highHalves + 2) / 2;   // HIGH halves plus one LOW half
+
+    if (count > pulse.symbolCapacity) {
+        rmt_data_t* symbols = (rmt_data_t*)realloc(pulse.symbols, count * sizeof(rmt_data_t));
+        if (symbols == nullptr) return false;
+        pulse.symbols = symbols;
+        pulse.symbolCapacity = count;
+    }
+
+    // HIGH for the whole duration (split across halves), then LOW. A
+    // zero-length half after the LOW one marks the end of the waveform.
+    for (size_t half = 0; half < 2 * count; half++) {
+        uint32_t length = 0;
+        uint32_t level = LOW;
+        if (half < highHalves) {
+            length = (remaining > RMT_MAX_HALF_US) ? RMT_MAX_HALF_US : remaining;
+            remaining -= length;
+            level = HIGH;
+        } else if (half == highHalves) {
+            length = 1;
+        }
+
+        rmt_data_t& symbol = pulse.symbols[half / 2];
+        if (half % 2 == 0) {
+            symbol.duration0 = length;
+            symbol.level0 = level;
+        } else {
+            symbol.duration1 = length;
+            symbol.level1 = level;
         }
     }
 
-    // No handler found
-    if (_verboseLogging) {
-        Serial.print("   ⚠️  No handler registered for command: ");
-        Serial.println(command);
+    return rmtWriteAsync(pulse.pin, pulse.symbols, count);
+}
+#endif
+
+#ifdef INVENTRONIX_PRECISION_GPT
+// Claim a free GPT channel as the one-shot behind every precision pulse
+bool Inventronix::beginPrecisionTimer() {
+    if (_precisionTimerReady) return true;
+
+    uint8_t type = GPT_TIMER;
+    int8_t channel = FspTimer::get_available_timer(type);
+    if (channel < 0 || type != GPT_TIMER) return false;
+
+    // PCLKD / 16 - 3 ticks per microsecond on the UNO R4
+    _precisionTicksPerUs = R_FSP_SystemClockHzGet(FSP_PRIV_CLOCK_PCLKD) / 16 / 1000000;
+    if (_precisionTicksPerUs == 0) return false;
+
+    if (!_precisionTimer.begin(TIMER_MODE_ONE_SHOT, type, channel, 0xFFFF, 0, TIMER_SOURCE_DIV_16,
+                               precisionTimerCallback, this) ||
+        !_precisionTimer.setup_overflow_irq() ||
+        !_precisionTimer.open()) {
+        return false;
     }
+    _precisionTimer.stop();
+    _precisionTimerReady = true;
+    return true;
 }
 
-// Handle pulse off (called by Ticker)
-void Inventronix::handlePulseOff(int pulseIndex) {
-    if (pulseIndex < 0 || pulseIndex >= _pulseCount) return;
-    if (!_pulses[pulseIndex].active) return;
+// Arm the one-shot for the earliest precision off time (interrupts masked).
+// Waits beyond one 16-bit period are covered in several shots.
+void Inventronix::armPrecisionTimer() {
+    _precisionTimer.stop();
+    if (_precisionQueue.empty()) return;
+
+    int32_t wait = (int32_t)(_precisionQueue.topDeadline() - (uint32_t)micros());
+    uint32_t waitUs = (wait > 0) ? (uint32_t)wait : 0;
+    uint32_t maxWaitUs = 0xFFFF / _precisionTicksPerUs;
+    if (waitUs > maxWaitUs) waitUs = maxWaitUs;
+    uint32_t ticks = (waitUs > 0) ? waitUs * _precisionTicksPerUs : 1;
+    _precisionTimer.set_period(ticks);
+    _precisionTimer.reset();
+    _precisionTimer.start();
+}
 
-    if (_verboseLogging) {
-        Serial.print("⏹️  Pulse complete: ");
-        Serial.println(_pulses[pulseIndex].name);
+// GPT overflow interrupt - drop every due precision pulse, then re-arm
+void Inventronix::precisionTimerCallback(timer_callback_args_t* args) {
+    Inventronix* self = (Inventronix*)args->p_context;
+
+    // Allow for micros() and the timer rounding differently
+    uint32_t now = (uint32_t)micros() + 2;
+    int i;
+    while ((i = self->_precisionQueue.popDue(now)) >= 0) {
+        PulseHandler* pulse = self->_pulses[i];
+        bool ending = (pulse->state != PULSE_WAITING);
+        if (ending) {
+            digitalWrite(pulse->pin, LOW);
+        }
+        pulse->state = PULSE_IDLE;
+
+        // Follow-on pulses start from here too, so gaps are just as exact
+        if (pulse->followCount > 0) {
+            uint32_t start = (uint32_t)micros();
+            if (ending && pulse->minGapMs > 0) {
+                pulse->state = PULSE_WAITING;
+                self->_precisionQueue.schedule(i, start + pulse->minGapMs * 1000UL);
+            } else {
+                unsigned long durationMs = self->popFollowOn(*pulse);
+                digitalWrite(pulse->pin, HIGH);
+                pulse->state = PULSE_ACTIVE;
+                self->_precisionQueue.schedule(i, start + durationMs * 1000UL);
+            }
+        }
+    }
+    self->armPrecisionTimer();
+}
+#endif
+
+// Loop method - call this in your loop() for pulse timing on non-ESP platforms
+// and to run deferred commands. Returns how long until it is next needed.
+unsigned long Inventronix::loop() {
+    // Keep the WiFi connection moving (never blocks, except an opted-in
+    // roam scan on UNO R4, whose module answers only when the scan is done)
+    serviceWiFi();
+
+    // Release scheduled commands whose time has come
+    if (_scheduler.count() > 0) {
+        _scheduler.advance(millis(), [this](int slot) { runScheduledCommand(slot); });
+    }
+
+    if (_queueCount > 0) {
+        runQueuedCommands();
     }
 
-    if (_pulses[pulseIndex].pin >= 0) {
-        // Pin-based - turn off
-        digitalWrite(_pulses[pulseIndex].pin, LOW);
-    } else if (_pulses[pulseIndex].offCallback) {
-        // Callback-based - call off callback
-        _pulses[pulseIndex].offCallback();
+    // Ramps and PWM step lists
+    if (!_pwmQueue.empty()) {
+        servicePwm();
     }
 
-    _pulses[pulseIndex].active = false;
+#ifndef INVENTRONIX_PLATFORM_ESP
+    // End pulses whose time is up
+    servicePulses();
+#endif
+    // On ESP platforms, the pulse timer ends pulses; their off callbacks
+    // and logging still run here
+    processPulseEvents();
+
+    return msUntilDue();
 }
 
-// Loop method - call this in your loop() for pulse timing on non-ESP platforms
-void Inventronix::loop() {
+// ============================================
+// IDLE
+// ============================================
+
+// Milliseconds until loop() next has work: a pulse or PWM step ending, a
+// scheduled command, a WiFi timeout/retry/poll. Deferred commands and pulse
+// events waiting to run make it 0.
+unsigned long Inventronix::msUntilDue() {
+    if (_queueCount > 0 || !_pulseEvents.empty()) return 0;
+
+    uint32_t now = millis();
+    unsigned long due = INVENTRONIX_IDLE_MAX_MS;
+    auto until = [&](uint32_t deadline) {
+        int32_t remaining = (int32_t)(deadline - now);
+        unsigned long ms = remaining > 0 ? (unsigned long)remaining : 0;
+        if (ms < due) due = ms;
+    };
+
+    // (On ESP the pulse timer ends the pulse; its off callback runs here)
+    if (!_pulseQueue.empty()) until(_pulseQueue.topDeadline());
+    if (!_pwmQueue.empty()) until(_pwmQueue.topDeadline());
+    if (_scheduler.count() > 0) {
+        uint32_t scheduled = _scheduler.nextDueMs(now);
+        if (scheduled < due) due = scheduled;
+    }
+
+    if (_wifiManaged) {
+        switch (_wifiState) {
+            case WIFI_LINK_CONNECTING:
+            case WIFI_LINK_WAITING_IP:
+                until(_wifiAttemptAt + (_wifiFastAttempt ? INVENTRONIX_WIFI_FAST_TIMEOUT_MS
+                                                         : INVENTRONIX_WIFI_ATTEMPT_TIMEOUT_MS) + 1);
+                break;
+            case WIFI_LINK_RETRY_WAIT:
+                until(_wifiRetryAt);
+                break;
+            case WIFI_LINK_SCANNING:
+                until(_wifiAttemptAt + INVENTRONIX_WIFI_SCAN_TIMEOUT_MS + 1);
+                break;
+            case WIFI_LINK_UP:
+                if (_wifiRoamScan) {
+                    until(_wifiAttemptAt + INVENTRONIX_WIFI_SCAN_TIMEOUT_MS + 1);
+                } else if (_roamThresholdDbm != 0) {
+                    until(_wifiRssiAt + INVENTRONIX_WIFI_RSSI_POLL_MS);
+                }
+                break;
+            default:
+                break;
+        }
 #ifndef INVENTRONIX_PLATFORM_ESP
-    // Check all active pulses for timeout
-    unsigned long now = millis();
-    for (int i = 0; i < _pulseCount; i++) {
-        if (_pulses[i].registered && _pulses[i].active) {
-            if (now - _pulses[i].startTime >= _pulses[i].activeDuration) {
-                handlePulseOff(i);
-            }
+        // No WiFi events on UNO R4: the module is polled
+        until(_wifiPolledAt + INVENTRONIX_WIFI_POLL_MS);
+#endif
+    }
+
+    return due;
+}
+
+// Sleep until loop() is next due (or `maxMs`), waking early for events
+unsigned long Inventronix::idle(unsigned long maxMs) {
+    unsigned long ms = msUntilDue();
+    if (maxMs < ms) ms = maxMs;
+    if (ms == 0) return 0;
+
+    unsigned long start = millis();
+#ifdef INVENTRONIX_PLATFORM_ESP
+    if (ms >= INVENTRONIX_LIGHT_SLEEP_MIN_MS && WiFi.getMode() == WIFI_OFF && outputsIdle()) {
+        // Nothing that light sleep would stall (radio, LEDC, pulse timer):
+        // stop the clocks until the deadline
+        Serial.flush();
+        esp_sleep_enable_timer_wakeup((uint64_t)ms * 1000ULL);
+        esp_light_sleep_start();
+    } else {
+        // Block this task - the idle task halts the CPU between interrupts
+        // (and the modem sleeps between beacons) - until the deadline or a
+        // WiFi/pulse event. Clear any stale wake first, then check nothing
+        // arrived before _idleTask was set.
+        ulTaskNotifyTake(pdTRUE, 0);
+        _idleTask = xTaskGetCurrentTaskHandle();
+        if (_pulseEvents.empty()) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ms));
         }
+        _idleTask = nullptr;
+    }
+#else
+    // WFI halts the core until the next interrupt - at least every 1ms
+    // tick - so pulse ends from loop() keep millisecond accuracy
+    while (millis() - start < ms && _pulseEvents.empty()) {
+        __WFI();
     }
 #endif
-    // On ESP platforms, Ticker handles timing automatically - loop() is a no-op
+    return millis() - start;
+}
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+// No pulse, PWM output or ramp running?
+bool Inventronix::outputsIdle() {
+    if (!_pulseQueue.empty() || !_pwmQueue.empty()) return false;
+    for (int i = 0; i < _pulseCount; i++) {
+        if (_pulses[i]->state != PULSE_IDLE) return false;
+    }
+    for (int i = 0; i < _pwmCount; i++) {
+        if (_pwm[i].duty != 0) return false;
+    }
+    return true;
 }
+
+// Wake a task waiting in idle() (from the WiFi event task or pulse timer)
+void Inventronix::wakeIdle() {
+    TaskHandle_t task = _idleTask;
+    if (task != nullptr) {
+        xTaskNotifyGive(task);
+    }
+}
+#endif
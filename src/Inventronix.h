@@ -5,6 +5,16 @@
 #include <ArduinoJson.h>
 #include <functional>
 #include "InventronixConfig.h"
+#include "InventronixArena.h"
+#include "InventronixFormat.h"
+#include "InventronixPayload.h"
+#include "InventronixTemplate.h"
+#include "InventronixDispatch.h"
+#include "InventronixTimerWheel.h"
+#include "InventronixPulseHeap.h"
+#include "InventronixEventQueue.h"
+#include "InventronixArgs.h"
+#include "InventronixTransport.h"
 
 // Platform detection
 #if defined(ESP32) || defined(ESP8266)
@@ -12,23 +22,148 @@
     #include <WiFi.h>
     #include <WiFiClientSecure.h>
     #include <HTTPClient.h>
-    #include <Ticker.h>
+    #include <esp_timer.h>
 #elif defined(ARDUINO_UNOR4_WIFI) || defined(ARDUINO_ARCH_RENESAS_UNO)
     #define INVENTRONIX_PLATFORM_RENESAS
     #include <WiFiS3.h>
     #include <ArduinoHttpClient.h>
+#elif defined(INVENTRONIX_HOST)
+    // Linux host build (CMakeLists.txt): extras/host provides the UNO R4
+    // WiFi core API over sockets, so the R4 code paths run unchanged
+    #define INVENTRONIX_PLATFORM_HOST
+    #define INVENTRONIX_PLATFORM_RENESAS
+    #include <WiFiS3.h>
+    #include <ArduinoHttpClient.h>
 #else
     #error "Unsupported platform. This library requires ESP32, ESP8266, or Arduino UNO R4 WiFi."
 #endif
 
+// Hardware-timed (precision) pulses: RMT needs arduino-esp32 3.x
+#if defined(ESP32) && defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    #define INVENTRONIX_PRECISION_RMT
+#elif defined(INVENTRONIX_PLATFORM_RENESAS) && !defined(INVENTRONIX_PLATFORM_HOST)
+    #define INVENTRONIX_PRECISION_GPT
+    #include <FspTimer.h>
+#endif
+
+// PWM outputs: LEDC on ESP32 (pin-based API from arduino-esp32 3.x), PwmOut on R4
+#if defined(ESP32) && defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+    #define INVENTRONIX_LEDC_PIN_API
+#endif
+#ifdef INVENTRONIX_PLATFORM_RENESAS
+    #include <pwm.h>
+#endif
+
+// Built-in transport: HTTPClient over WiFiClientSecure on ESP32,
+// ArduinoHttpClient over WiFiSSLClient on UNO R4
+class InventronixPlatformTransport : public InventronixTransport {
+public:
+    InventronixPlatformTransport();
+    ~InventronixPlatformTransport();
+
+    int open(const char* host, uint16_t port, bool secure) override;
+    int writeRequest(const InventronixRequest& request) override;
+    int readStatus() override;
+    bool readHeader(String& name, String& value) override;
+    int readBody(uint8_t* buffer, size_t size) override;
+    void close() override;
+
+private:
+    const char* _host;
+    uint16_t _port;
+    bool _secure;
+    long _bodyLeft;             // -1 = length unknown (chunked or close-delimited)
+#ifdef INVENTRONIX_PLATFORM_ESP
+    WiFiClientSecure _client;
+    HTTPClient _http;
+    int _status;                // HTTPClient reads the status line while sending
+    int _headerIndex;
+    String _body;               // Unknown-length bodies, de-chunked by HTTPClient
+    unsigned int _bodyOffset;
+    bool _bodyBuffered;
+#else
+    // R4 WiFi requires persistent SSL client (must not be local variable)
+    WiFiSSLClient _client;
+    // HttpClient has no default constructor; it is built in place by open()
+    alignas(HttpClient) uint8_t _httpStorage[sizeof(HttpClient)];
+    HttpClient* _http;
+    bool _bodyStarted;
+#endif
+
+    InventronixPlatformTransport(const InventronixPlatformTransport&) = delete;
+    InventronixPlatformTransport& operator=(const InventronixPlatformTransport&) = delete;
+};
+
 // Max registered commands (adjust based on memory constraints)
+#ifndef INVENTRONIX_MAX_COMMANDS
 #define INVENTRONIX_MAX_COMMANDS 16
-#define INVENTRONIX_MAX_PULSES 8
+#endif
+#ifndef INVENTRONIX_MAX_PWM
+#define INVENTRONIX_MAX_PWM 8
+#endif
+#ifndef INVENTRONIX_MAX_OUTPUT_GROUPS
+#define INVENTRONIX_MAX_OUTPUT_GROUPS 4
+#endif
 
 // Callback types
 using CommandCallback = std::function<void(JsonObject args)>;
 using PulseOnCallback = std::function<void()>;
 using PulseOffCallback = std::function<void()>;
+using ScheduledCommandCallback = std::function<void(const char* command, const char* executionId,
+                                                    unsigned long dueInMs)>;
+using DutyCycleSampleCallback = std::function<void(InventronixPayload& payload)>;
+
+// Duty-cycle bookkeeping (runDutyCycle), kept across deep sleep
+struct DutyCycleStats {
+    uint32_t cycle;             // Wakes since power-on, this one included
+    unsigned long awakeMs;      // Previous cycle: start to sleep
+    unsigned long radioMs;      // Previous cycle: WiFi on time (0 = no upload)
+    uint16_t pendingSamples;    // Samples waiting in RTC memory
+};
+
+// Where the library-managed WiFi connection is (beginWiFi/connectWiFi)
+enum WiFiLinkState : uint8_t {
+    WIFI_LINK_OFF,              // Not managed by the library
+    WIFI_LINK_CONNECTING,       // Joining the network
+    WIFI_LINK_WAITING_IP,       // Joined, waiting for DHCP
+    WIFI_LINK_UP,               // Connected with an IP address
+    WIFI_LINK_RETRY_WAIT,       // Last attempt failed; retrying after a backoff
+    WIFI_LINK_SCANNING          // Looking for the strongest known access point
+};
+
+using WiFiStateCallback = std::function<void(WiFiLinkState state)>;
+
+// A network the library may join (addWiFiNetwork)
+struct WiFiNetwork {
+    String ssid;
+    String password;
+    uint32_t ssidHash;
+};
+
+// An access point of a known network found by a scan. Candidates are kept
+// strongest first; on UNO R4 (no BSSID selection) one per network.
+struct WiFiCandidate {
+    uint8_t network;            // Index into the network list
+    int8_t rssi;                // dBm (0 = not seen; joined by SSID)
+    int32_t channel;            // 0 = join by SSID (any access point)
+    uint8_t bssid[6];
+};
+
+// What a pulse does with a repeat command while it is already running
+enum PulsePolicy : uint8_t {
+    PULSE_IGNORE,       // Drop the repeat (default)
+    PULSE_RESTART,      // Restart the off timer with the new duration
+    PULSE_EXTEND,       // Add the new duration to the time remaining
+    PULSE_QUEUE         // Run it after the current pulse, with a minimum gap
+};
+
+// Per-pulse counts of how repeat commands were handled
+struct PulseStats {
+    unsigned long dropped;
+    unsigned long restarted;
+    unsigned long extended;
+    unsigned long queued;
+};
 
 // Command registration entry
 struct CommandHandler {
@@ -37,6 +172,27 @@ struct CommandHandler {
     bool registered;
 };
 
+// Pulse lifecycle. Written by both loop() and the pulse timer, so it is atomic.
+// PULSE_WAITING means the heap entry is the end of a gap, not an off time.
+enum PulseState : uint8_t {
+    PULSE_IDLE,
+    PULSE_ACTIVE,
+    PULSE_WAITING
+};
+
+// Work the pulse timer hands to loop(): anything that may call user code or Serial
+enum PulseEventType : uint8_t {
+    PULSE_EVENT_ENDED,          // Pin pulse finished (log only)
+    PULSE_EVENT_OFF,            // Callback pulse finished: run offCallback
+    PULSE_EVENT_START           // Follow-on pulse due: start it from loop()
+};
+
+struct PulseEvent {
+    uint16_t index;
+    PulseEventType type;
+    unsigned long durationMs;   // PULSE_EVENT_START only
+};
+
 // Pulse command entry
 struct PulseHandler {
     String name;
@@ -44,37 +200,176 @@ struct PulseHandler {
     unsigned long durationMs;   // 0 = pull from command args
     PulseOnCallback onCallback;
     PulseOffCallback offCallback;
-#ifdef INVENTRONIX_PLATFORM_ESP
-    Ticker ticker;
-#else
-    unsigned long startTime;    // For millis-based timing on non-ESP platforms
-    unsigned long activeDuration;
+    bool precision;             // Edges generated by hardware (onPrecisionPulse)
+#ifdef INVENTRONIX_PRECISION_RMT
+    rmt_data_t* symbols;        // RMT waveform, sized for the longest pulse so far
+    size_t symbolCapacity;
+#endif
+    std::atomic<uint8_t> state; // PulseState
+
+    // Repeat handling (setPulsePolicy). Follow-on pulses wait in a small ring.
+    PulsePolicy policy;
+    unsigned long minGapMs;
+    unsigned long* followOns;
+    uint8_t followLimit;
+    uint8_t followHead;
+    uint8_t followCount;
+    PulseStats stats;
+
+    bool registered;
+};
+
+// One step of a PWM waveform
+struct PwmStep {
+    uint16_t duty;              // Hundredths of a percent (0-10000)
+    uint32_t rampMs;            // Time to move to `duty` from the previous level
+    uint32_t holdMs;            // Time to stay at `duty` before the next step
+};
+
+// PWM command entry
+struct PwmHandler {
+    String name;
+    int pin;
+    uint32_t frequencyHz;
+    unsigned long defaultRampMs;    // onRamp: ramp time when the command gives none
+    PwmStep steps[INVENTRONIX_PWM_MAX_STEPS];
+    uint8_t stepCount;
+    uint8_t stepIndex;
+    uint16_t repeatsLeft;       // Further runs of the step list (PWM_REPEAT_FOREVER = until replaced)
+    uint16_t duty;              // Current output level (hundredths of a percent)
+    uint16_t rampFrom;
+    unsigned long rampStart;
+    bool ramping;
+    bool registered;
+#ifdef INVENTRONIX_PLATFORM_RENESAS
+    PwmOut* output;
+#elif !defined(INVENTRONIX_LEDC_PIN_API)
+    uint8_t channel;            // LEDC channel (arduino-esp32 2.x)
 #endif
-    bool active;                // Currently pulsing?
+};
+
+// Output group entry: pins switched together from one bitmap. Each pin's
+// port and bit are resolved at registration, so applying a bitmap is a
+// set/clear register write per port.
+struct OutputGroup {
+    String name;
+    uint8_t pinCount;
+    uint8_t portCount;
+    uint8_t pinPort[INVENTRONIX_OUTPUT_GROUP_MAX_PINS];     // index into the port registers below
+    uint32_t pinMask[INVENTRONIX_OUTPUT_GROUP_MAX_PINS];    // bit within that port
+    volatile uint32_t* outRegister[INVENTRONIX_OUTPUT_GROUP_MAX_PORTS];    // ESP32 GPIO_OUT / RA4M1 PCNTR3
+    uint32_t state;             // Last applied bitmap (bit i = pins[i])
     bool registered;
 };
 
+// Execution result waiting to be reported to the server
+struct CommandAck {
+    char executionId[INVENTRONIX_EXECUTION_ID_LENGTH];
+    char result[INVENTRONIX_ACK_RESULT_LENGTH];   // Empty = no result
+    bool success;
+};
+
+// Command parsed from a response and copied out of the parse arena,
+// waiting for loop() to run it (deferred mode)
+struct QueuedCommand {
+    char name[INVENTRONIX_COMMAND_NAME_LENGTH];
+    char executionId[INVENTRONIX_EXECUTION_ID_LENGTH];
+    char args[INVENTRONIX_COMMAND_ARGS_SIZE];   // Arguments as serialised JSON
+    uint16_t argsLength;
+};
+
+// Recently accepted command, remembered to suppress replays
+struct ExecutionRecord {
+    uint32_t idHash;            // FNV-1a of execution_id
+    unsigned long updatedAt;    // millis() when accepted, then when finished
+    bool live;                  // Cleared if the command was dropped without running
+    bool finished;              // Outcome below is known
+    bool success;
+    char result[INVENTRONIX_ACK_RESULT_LENGTH];   // Empty = no result
+};
+
 class Inventronix {
 public:
+    using Payload = InventronixPayload;
+    using PayloadTemplate = InventronixTemplate;
+
     Inventronix();
+    ~Inventronix();
 
     // Setup methods
-    void begin(const char* projectId, const char* apiKey);
+    void begin(const char* projectId, const char* apiKey,
+               size_t parseArenaSize = INVENTRONIX_PARSE_ARENA_SIZE);
     void setSchemaId(const char* schemaId);
 
-    // WiFi management
+    // WiFi management. beginWiFi() returns at once and loop() (or
+    // sendPayload()) moves the connection along, reconnecting with backoff
+    // when it drops. connectWiFi() does the same but waits up to timeoutMs
+    // for the first connection - convenient in setup().
+    void beginWiFi(const char* ssid, const char* password);
     bool connectWiFi(const char* ssid, const char* password, unsigned long timeoutMs = 30000);
+
+    // Several networks, or several access points of one: add each network,
+    // then call beginWiFi()/connectWiFi() without credentials. The library
+    // scans, joins the strongest known access point, and roams to a stronger
+    // one when the signal stays below the roaming threshold.
+    bool addWiFiNetwork(const char* ssid, const char* password);
+    void beginWiFi();
+    bool connectWiFi(unsigned long timeoutMs = 30000);
+    void setWiFiRoaming(int8_t thresholdDbm, unsigned long holdMs = INVENTRONIX_WIFI_ROAM_HOLD_MS);
+    int8_t wifiRSSI();                  // dBm of the current link (0 if not connected)
+    const char* wifiSSID() const;       // Network in use ("" if none)
+    unsigned long wifiRoamCount() const;
     bool isWiFiConnected();
+    WiFiLinkState wifiState() const;
+    void onWiFiStateChange(WiFiStateCallback callback);
+
+    // Use a fixed address instead of DHCP (call before beginWiFi/connectWiFi;
+    // dns defaults to the gateway)
+    void setStaticIP(IPAddress ip, IPAddress gateway, IPAddress subnet,
+                     IPAddress dns = IPAddress(0, 0, 0, 0));
+
+    // Forget the cached access point and lease, so the next connect scans
+    void clearWiFiCache();
 
     // Core functionality
     bool sendPayload(const char* jsonPayload);
+    bool sendPayload(const Payload& payload);
+    bool sendPayload(const PayloadTemplate& payloadTemplate);
+
+    // Start building a payload in the library-owned transmit buffer
+    Payload& beginPayload();
 
     // Call this in your loop() for pulse timing on non-ESP platforms
-    void loop();
+    // and to run deferred commands. Returns the milliseconds until the
+    // library next needs it (0 = call again straight away).
+    unsigned long loop();
+
+    // Sleep until loop() is next due, or for `maxMs` if sooner: light sleep
+    // on ESP32 when WiFi is off and no output is running, otherwise a task
+    // wait (ESP32, woken early by WiFi and pulse events) or WFI (UNO R4).
+    // Returns the milliseconds slept.
+    unsigned long idle(unsigned long maxMs = INVENTRONIX_IDLE_MAX_MS);
 
     // Command registration - toggle style
     void onCommand(const char* commandName, CommandCallback callback);
 
+    // Command registration - typed arguments, e.g.
+    //   onCommand<int, float>("set_target", {{"zone", 0, 7}, {"temp", 5, 40}},
+    //                         [](int zone, float temp) { ... });
+    // Every argument is checked (present, right type, in range) before the
+    // handler runs; otherwise the command is acked as failed.
+    template <typename... Args, typename Handler>
+    void onCommand(const char* commandName, const ArgSpec (&args)[sizeof...(Args)], Handler handler) {
+        InventronixTypedCommand<Args...> typed(args, handler);
+        onCommand(commandName, [this, typed](JsonObject json) {
+            const char* badKey = nullptr;
+            ArgError error = typed.invoke(json, badKey);
+            if (error != ARG_OK) {
+                rejectArgs(badKey, error);
+            }
+        });
+    }
+
     // Pulse registration - pin-based (simple)
     void onPulse(const char* commandName, int pin, unsigned long durationMs = 0);
 
@@ -82,14 +377,101 @@ public:
     void onPulse(const char* commandName, unsigned long durationMs,
                  PulseOnCallback onCb, PulseOffCallback offCb);
 
+    // Pulse registration - hardware-timed, for pulse widths accurate to
+    // microseconds regardless of WiFi or loop() load (pin-based only)
+    void onPrecisionPulse(const char* commandName, int pin, unsigned long durationMs = 0);
+
+    // Start a registered pulse locally, as if the server had sent it
+    // (durationMs = 0 uses the registered duration)
+    bool triggerPulse(const char* commandName, unsigned long durationMs = 0);
+
+    // Choose how a running pulse handles repeat commands. maxQueued and
+    // minGapMs apply to PULSE_QUEUE (and to restart/extend requests that
+    // arrive as a pulse is ending, which run as one follow-on pulse).
+    bool setPulsePolicy(const char* commandName, PulsePolicy policy,
+                        uint8_t maxQueued = 1, unsigned long minGapMs = 0);
+
+    // PWM registration - the command sets the duty (percent), optionally with
+    // "frequency", "ramp_ms", or a "steps" waveform list, all run on-device
+    void onPwm(const char* commandName, int pin,
+               uint32_t frequencyHz = INVENTRONIX_DEFAULT_PWM_FREQUENCY);
+
+    // PWM registration with a soft ramp when the command gives no ramp_ms
+    void onRamp(const char* commandName, int pin, unsigned long rampMs,
+                uint32_t frequencyHz = INVENTRONIX_DEFAULT_PWM_FREQUENCY);
+
+    // Current PWM duty in percent (0 if not registered)
+    float pwmDuty(const char* commandName);
+
+    // Output group registration - the command's "bits" (bit i = pins[i],
+    // optionally limited by "mask") or "states" list switches every pin at once
+    void onOutputGroup(const char* commandName, const int* pins, uint8_t pinCount);
+    template <size_t N>
+    void onOutputGroup(const char* commandName, const int (&pins)[N]) {
+        onOutputGroup(commandName, pins, (uint8_t)N);
+    }
+
+    // Apply a bitmap locally; only pins whose bit is set in `mask` change
+    bool setOutputGroup(const char* commandName, uint32_t bits, uint32_t mask = 0xFFFFFFFF);
+    uint32_t outputGroupState(const char* commandName);
+
     // Pulse status helpers
     bool isPulsing(const char* commandName);
+    PulseStats pulseStats(const char* commandName);
+
+    // Call from inside an onCommand handler to report the outcome in its ack
+    // (commands succeed by default)
+    void setCommandResult(bool success, const char* result = nullptr);
+
+    // Acks waiting for the next ingest request, and acks lost to a full buffer
+    int pendingAckCount() const;
+    unsigned long droppedAckCount() const;
 
     // Configuration
     void setRetryAttempts(int attempts);
     void setRetryDelay(int milliseconds);
     void setVerboseLogging(bool enabled);
     void setDebugMode(bool enabled);
+    void setCommandAcks(bool enabled);   // Off by default
+
+    // Send requests through another transport (e.g. instrumented, or an
+    // in-memory loopback). It must outlive this object; nullptr restores the
+    // built-in HTTPClient / ArduinoHttpClient transport.
+    void setTransport(InventronixTransport* transport);
+
+    // Deferred mode: commands are queued by sendPayload() and run from loop(),
+    // spending at most budgetUs per loop() call (at least one command runs)
+    void setDeferredCommands(bool enabled,
+                             unsigned long budgetUs = INVENTRONIX_DEFAULT_COMMAND_BUDGET_US);
+    int queuedCommandCount() const;
+    unsigned long commandQueueOverflows() const;
+
+    // Commands sent with execute_at (Unix time) or delay_ms wait on a timer
+    // wheel driven by loop()
+    int scheduledCommandCount() const;
+    void listScheduledCommands(ScheduledCommandCallback callback);
+    bool cancelScheduledCommand(const char* executionId);
+
+    // Deep-sleep duty cycle: take a sample each wake, upload every
+    // `uploadEvery` wakes (all stored samples in one request), run the
+    // commands it returns, then deep sleep until the next period. Call at the
+    // end of setup(); it does not return. On UNO R4 the same cycle runs with
+    // the radio off and delay() in place of deep sleep.
+    void runDutyCycle(const char* ssid, const char* password, unsigned long periodMs,
+                      DutyCycleSampleCallback sample, uint8_t uploadEvery = 1);
+    DutyCycleStats dutyCycleStats() const;
+
+    // Server clock, learned from the Date header of ingest responses
+    bool hasServerTime() const;
+    uint32_t serverTime() const;  // Unix seconds (0 if not yet known)
+
+    // Commands whose execution_id was seen within the TTL are not run again
+    void setDedupTtl(unsigned long milliseconds);
+    unsigned long duplicateCommandsSuppressed() const;
+
+    // Parse arena diagnostics (bytes)
+    size_t parseArenaSize() const;
+    size_t parseArenaHighWater() const;
 
 private:
     // Member variables
@@ -101,42 +483,244 @@ private:
     bool _verboseLogging;
     bool _debugMode;
 
-    // WiFi credentials (stored for reconnection)
-    String _wifiSsid;
-    String _wifiPassword;
+    // WiFi networks (stored for reconnection) and scan results
+    WiFiNetwork _wifiNetworks[INVENTRONIX_WIFI_MAX_NETWORKS];
+    uint8_t _wifiNetworkCount;
+    uint8_t _wifiNetwork;       // Network of the current attempt/link
+    WiFiCandidate _wifiCandidates[INVENTRONIX_WIFI_MAX_CANDIDATES];
+    uint8_t _wifiCandidateCount;
+    uint8_t _wifiNextCandidate; // Next one to try if this attempt fails
     bool _wifiManaged;  // true if we're managing WiFi
 
+    // Roaming: the link's RSSI is sampled while up; staying under the
+    // threshold for the hold time starts a scan for a stronger access point
+    int8_t _roamThresholdDbm;   // 0 = never roam
+    unsigned long _roamHoldMs;
+    int8_t _wifiRssi;
+    unsigned long _wifiRssiAt;
+    unsigned long _wifiWeakSince;
+    bool _wifiWeak;
+    bool _wifiRoamScan;         // Scanning while connected
+    unsigned long _roamScanAt;  // No roam scan before this
+    unsigned long _wifiRoams;
+
+    // WiFi connection state machine
+    WiFiLinkState _wifiState;
+    WiFiStateCallback _wifiStateCallback;
+    unsigned long _wifiAttemptAt;
+    unsigned long _wifiRetryAt;
+    unsigned long _wifiBackoffMs;
+    bool _wifiFastAttempt;      // This attempt uses the cached AP (and lease)
+    bool _staticIpSet;
+    IPAddress _staticIp;
+    IPAddress _staticGateway;
+    IPAddress _staticSubnet;
+    IPAddress _staticDns;
+#ifdef INVENTRONIX_PLATFORM_ESP
+    bool _wifiAddressFixed;     // WiFi.config() currently holds a fixed address
+    // Latest radio level, written by the WiFi event task
+    std::atomic<uint8_t> _wifiRadio;
+    wifi_event_id_t _wifiEventId;
+    bool _wifiEventsAttached;
+#else
+    unsigned long _wifiPolledAt;
+#endif
+
     // Command registry
     CommandHandler _commands[INVENTRONIX_MAX_COMMANDS];
     int _commandCount;
 
-    // Pulse registry
-    PulseHandler _pulses[INVENTRONIX_MAX_PULSES];
+    // Pulse registry - each handler is allocated once and never moves, so the
+    // pulse timer can use it while more pulses are being registered
+    PulseHandler** _pulses;
     int _pulseCount;
+    int _pulseCapacity;
+
+    // Running pulses ordered by off time. One timer (esp_timer on ESP,
+    // loop() elsewhere) services the earliest deadline.
+    InventronixPulseHeap _pulseQueue;
+#ifdef INVENTRONIX_PLATFORM_ESP
+    esp_timer_handle_t _pulseTimer;
+    portMUX_TYPE _pulseLock;
+    std::atomic<TaskHandle_t> _idleTask;   // Task waiting in idle(), woken by events
+#endif
+    // Pulse ends and follow-on starts passed from the pulse timer to loop()
+    InventronixEventQueue<PulseEvent, INVENTRONIX_EVENT_QUEUE_SIZE> _pulseEvents;
+#ifdef INVENTRONIX_PRECISION_GPT
+    // Precision pulses ordered by off time in microseconds, ended from the
+    // overflow interrupt of one GPT one-shot
+    InventronixPulseHeap _precisionQueue;
+    FspTimer _precisionTimer;
+    uint32_t _precisionTicksPerUs;
+    bool _precisionTimerReady;
+#endif
+
+    // PWM registry, and the next ramp update / step change for each output
+    PwmHandler _pwm[INVENTRONIX_MAX_PWM];
+    int _pwmCount;
+    InventronixPulseHeap _pwmQueue;
+
+    // Output group registry
+    OutputGroup _groups[INVENTRONIX_MAX_OUTPUT_GROUPS];
+    int _groupCount;
+
+    // Name hash -> command/pulse/PWM/group slot, built as handlers are registered
+    InventronixDispatchIndex _dispatchIndex;
+
+    // Pending command acks (ring buffer, oldest first)
+    CommandAck _acks[INVENTRONIX_ACK_BUFFER_SIZE];
+    int _ackHead;
+    int _ackCount;
+    unsigned long _acksDropped;
+    bool _commandAcks;
+    char* _ackScratch;          // Body for payloads outside _txBuffer, reused
+    size_t _ackScratchSize;
+
+    // Deferred command queue (ring buffer, oldest first)
+    QueuedCommand _commandQueue[INVENTRONIX_COMMAND_QUEUE_DEPTH];
+    int _queueHead;
+    int _queueCount;
+    unsigned long _queueOverflows;
+    bool _deferredCommands;
+    unsigned long _commandBudgetUs;
+
+    // Commands waiting for their execute_at/delay_ms time, indexed by the
+    // timer wheel's pool slots
+    InventronixTimerWheel _scheduler;
+    QueuedCommand _scheduledCommands[INVENTRONIX_MAX_SCHEDULED_COMMANDS];
+
+    // Server clock sync (Date header)
+    uint32_t _serverEpochAtSync;
+    unsigned long _millisAtSync;
+    bool _clockSynced;
+
+    // Recently seen execution_ids (ring buffer, oldest overwritten first)
+    ExecutionRecord _recentExecutions[INVENTRONIX_DEDUP_CACHE_SIZE];
+    int _recentNext;
+    int _recentCount;
+    unsigned long _dedupTtl;
+    unsigned long _duplicatesSuppressed;
+
+    // Outcome reported by the handler currently running
+    bool _resultSuccess;
+    const char* _resultValue;
+
+    // Library-owned transmit buffer and the builder writing into it
+    char _txBuffer[INVENTRONIX_TX_BUFFER_SIZE];
+    Payload _payload;
+
+    // Fixed-size pool used by ArduinoJson while parsing command responses,
+    // and how many handlers up the stack are still using what it holds
+    InventronixArena _parseArena;
+    uint8_t _parseDepth;
 
     // Private helper methods
     String buildURL();
     void logError(int statusCode, const String& responseBody);
     void logSuccess();
     void logDebug(const String& message);
-    bool ensureWiFi();  // Check and reconnect if needed
-    bool tryReconnectWiFi(unsigned long timeoutMs = 10000);
+    bool ensureWiFi();  // Check the link without blocking
+    void serviceWiFi();
+    void startWiFiAttempt();
+    void startWiFiScan();
+    bool finishWiFiScan(int found);
+    void rankWiFiScan(int found);
+    void joinWiFi(int network, const WiFiCandidate* accessPoint);
+    void failWiFiAttempt(const char* reason);
+    void checkRoaming(unsigned long now);
+    int cachedWiFiNetwork();
+    void setWiFiState(WiFiLinkState state);
+    void applyWiFiAddress();
+    void saveWiFiCache();
+    uint8_t readWiFiRadio(bool needIp);
     int sendHTTPRequest(const char* jsonPayload, String& responseBody);
+    String buildPath();
 
-#ifdef INVENTRONIX_PLATFORM_RENESAS
-    // R4 WiFi requires persistent SSL client (must not be local variable)
-    WiFiSSLClient _sslClient;
-#endif
+    // Request transport: the built-in one unless setTransport() gave another
+    InventronixPlatformTransport _platformTransport;
+    InventronixTransport* _transport;
 
     // Command processing
     void processCommands(const String& responseBody);
+    void runCommands(JsonDocument& doc, const String& responseBody);
+    void rejectArgs(const char* key, ArgError error);
     void dispatchCommand(const char* command, JsonObject args, const char* executionId);
-    void handlePulseOff(int pulseIndex);
+    bool isDuplicateExecution(const char* executionId);
+    int findExecution(const char* executionId, bool ignoreTtl);
+    void rememberExecution(const char* executionId);
+    void forgetExecution(const char* executionId);
+    void completeCommand(const char* executionId, bool success, const char* result);
+    bool enqueueCommand(const char* command, JsonObject args, const char* executionId);
+    const char* copyCommand(QueuedCommand& slot, const char* command, JsonObject args,
+                            const char* executionId);
+    void runQueuedCommands();
+    void dispatchQueued(QueuedCommand& slot);
+    void dispatchStored(JsonDocument& doc, QueuedCommand& slot);
+    bool commandDelay(JsonObject cmd, JsonObject args, unsigned long& delayMs);
+    bool scheduleCommand(const char* command, JsonObject args, const char* executionId,
+                         unsigned long delayMs);
+    void runScheduledCommand(int slot);
+    void syncServerClock(const char* httpDate);
+    int findCommand(const char* name, uint32_t nameHash);
+    void queueAck(const char* executionId, bool success, const char* result);
+    const char* attachAcks(const char* jsonPayload, int& attached, char*& ackStart);
+    size_t writeAcks(char* out, size_t capacity, int& attached);
+    bool postIngest(const char* body, int acksAttached, char* ackStart);
+    bool retryWithoutAcks(const char* body, int acksAttached);
+    void detachAcks(char* ackStart);
+    void releaseAcks(int count);
 
+    // Duty cycle
+    void restoreDutyCycle();
+    void saveDutyCycle(uint32_t sleepMs);
+    void storeSample(const char* json);
+    bool uploadSamples();
+    bool dutyWorkPending();
+    void stopWiFi();
+
+    // Idle
+    unsigned long msUntilDue();
+#ifdef INVENTRONIX_PLATFORM_ESP
+    bool outputsIdle();
+    void wakeIdle();
+#endif
+
+    int findPulse(const char* name, uint32_t nameHash);
+
+    // PWM engine
+    int findPwm(const char* name, uint32_t nameHash);
+    const char* dispatchPwm(int index, JsonObject args);
+    void startPwmStep(int index);
+    void holdPwmStep(int index);
+    void writePwm(PwmHandler& pwm, uint16_t duty);
+    void setPwmFrequency(PwmHandler& pwm, uint32_t frequencyHz);
+    void servicePwm();
+
+    // Output groups
+    int findOutputGroup(const char* name, uint32_t nameHash);
+    void applyOutputGroup(OutputGroup& group, uint32_t bits, uint32_t mask);
+
+    // Pulse scheduling
+    PulseHandler* addPulse(const char* commandName);
+    const char* beginPulse(int index, unsigned long durationMs);
+    const char* repeatPulse(int index, unsigned long durationMs);
+    bool adjustPulse(int index, unsigned long durationMs);
+    bool startPulseOutput(int index, unsigned long durationMs);
+    bool pushFollowOn(PulseHandler& pulse, unsigned long durationMs);
+    unsigned long popFollowOn(PulseHandler& pulse);
+    bool servicePulses();
+    void processPulseEvents();
+#ifdef INVENTRONIX_PRECISION_RMT
+    bool writePrecisionPulse(PulseHandler& pulse, unsigned long durationMs);
+#endif
+#ifdef INVENTRONIX_PRECISION_GPT
+    bool beginPrecisionTimer();
+    void armPrecisionTimer();
+    static void precisionTimerCallback(timer_callback_args_t* args);
+#endif
 #ifdef INVENTRONIX_PLATFORM_ESP
-    // Static callback for Ticker (ESP32 Ticker doesn't support lambdas with captures)
-    static Inventronix* _instance;
-    static void pulseOffCallback(int pulseIndex);
+    void armPulseTimer(uint32_t minDelayUs = 1);
+    static void pulseTimerCallback(void* arg);
 #endif
 };
 
@@ -0,0 +1,104 @@
+#include "InventronixArena.h"
+
+// Every block is prefixed with its size so reallocate() can copy it
+struct ArenaBlockHeader {
+    size_t size;
+};
+
+static const size_t ARENA_ALIGN = 8;
+static const size_t ARENA_HEADER = (sizeof(ArenaBlockHeader) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+static const size_t ARENA_NO_BLOCK = (size_t)-1;
+
+static inline size_t alignUp(size_t n) {
+    return (n + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+}
+
+InventronixArena::InventronixArena()
+    : _buffer(nullptr), _size(0), _used(0), _highWater(0), _lastOffset(ARENA_NO_BLOCK) {
+}
+
+InventronixArena::~InventronixArena() {
+    free(_buffer);
+}
+
+bool InventronixArena::begin(size_t size) {
+    size = alignUp(size);
+    if (_buffer != nullptr && _size == size) {
+        reset();
+        return true;
+    }
+
+    free(_buffer);
+    _buffer = (uint8_t*)malloc(size);
+    _size = (_buffer != nullptr) ? size : 0;
+    _highWater = 0;
+    reset();
+    return _buffer != nullptr;
+}
+
+void InventronixArena::reset() {
+    _used = 0;
+    _lastOffset = ARENA_NO_BLOCK;
+}
+
+void* InventronixArena::allocate(size_t size) {
+    size_t needed = ARENA_HEADER + alignUp(size);
+    if (_buffer == nullptr || needed > _size - _used) {
+        return nullptr;  // ArduinoJson reports this as NoMemory
+    }
+
+    ArenaBlockHeader* header = (ArenaBlockHeader*)(_buffer + _used);
+    header->size = size;
+    _lastOffset = _used;
+    _used += needed;
+    if (_used > _highWater) {
+        _highWater = _used;
+    }
+    return _buffer + _lastOffset + ARENA_HEADER;
+}
+
+void InventronixArena::deallocate(void* ptr) {
+    if (ptr == nullptr || _lastOffset == ARENA_NO_BLOCK) return;
+
+    // Only the most recent block can be returned; everything else is
+    // reclaimed by reset()
+    if ((uint8_t*)ptr == _buffer + _lastOffset + ARENA_HEADER) {
+        _used = _lastOffset;
+        _lastOffset = ARENA_NO_BLOCK;
+    }
+}
+
+void* InventronixArena::reallocate(void* ptr, size_t newSize) {
+    if (ptr == nullptr) {
+        return allocate(newSize);
+    }
+
+    uint8_t* block = (uint8_t*)ptr;
+    ArenaBlockHeader* header = (ArenaBlockHeader*)(block - ARENA_HEADER);
+
+    // Most recent block: grow or shrink in place
+    if (_lastOffset != ARENA_NO_BLOCK && block == _buffer + _lastOffset + ARENA_HEADER) {
+        size_t needed = ARENA_HEADER + alignUp(newSize);
+        if (needed > _size - _lastOffset) {
+            return nullptr;
+        }
+        header->size = newSize;
+        _used = _lastOffset + needed;
+        if (_used > _highWater) {
+            _highWater = _used;
+        }
+        return ptr;
+    }
+
+    // Older block: shrinking is free, growing needs a copy
+    if (newSize <= header->size) {
+        header->size = newSize;
+        return ptr;
+    }
+
+    void* moved = allocate(newSize);
+    if (moved != nullptr) {
+        memcpy(moved, ptr, header->size);
+    }
+    return moved;
+}
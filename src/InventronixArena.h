@@ -0,0 +1,41 @@
+#ifndef INVENTRONIX_ARENA_H
+#define INVENTRONIX_ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Fixed-size bump allocator handed to ArduinoJson for response parsing.
+// The buffer is allocated once in begin() and reset (not freed) between
+// responses, so command parsing never touches the heap after startup.
+class InventronixArena : public ArduinoJson::Allocator {
+public:
+    InventronixArena();
+    ~InventronixArena();
+
+    // Allocate the backing buffer (call once, typically from Inventronix::begin)
+    bool begin(size_t size);
+
+    // Forget every allocation - the buffer is reused for the next document
+    void reset();
+
+    size_t size() const { return _size; }
+    size_t used() const { return _used; }
+    size_t highWater() const { return _highWater; }
+
+    // ArduinoJson::Allocator
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t newSize) override;
+
+private:
+    uint8_t* _buffer;
+    size_t _size;
+    size_t _used;
+    size_t _highWater;
+    size_t _lastOffset;  // Offset of the most recent block (can grow/shrink in place)
+
+    InventronixArena(const InventronixArena&) = delete;
+    InventronixArena& operator=(const InventronixArena&) = delete;
+};
+
+#endif
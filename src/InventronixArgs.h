@@ -0,0 +1,166 @@
+#ifndef INVENTRONIX_ARGS_H
+#define INVENTRONIX_ARGS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <functional>
+#include <string.h>
+#include <tuple>
+#include <type_traits>
+#include "InventronixDispatch.h"
+
+// One typed command argument: its key and, optionally, the accepted range.
+// {"zone"} takes any value of the right type; {"temp", 5, 40} also requires
+// 5 <= temp <= 40 (for strings the range applies to the length).
+struct ArgSpec {
+    const char* key;
+    double minValue;
+    double maxValue;
+    bool ranged;
+
+    ArgSpec()
+        : key(nullptr), minValue(0), maxValue(0), ranged(false) {}
+    ArgSpec(const char* argKey)
+        : key(argKey), minValue(0), maxValue(0), ranged(false) {}
+    ArgSpec(const char* argKey, double minAllowed, double maxAllowed)
+        : key(argKey), minValue(minAllowed), maxValue(maxAllowed), ranged(true) {}
+};
+
+// Why a typed command's arguments were rejected (the ack result)
+enum ArgError : uint8_t {
+    ARG_OK,
+    ARG_MISSING,
+    ARG_WRONG_TYPE,
+    ARG_OUT_OF_RANGE
+};
+
+inline const char* argErrorName(ArgError error) {
+    switch (error) {
+        case ARG_MISSING:      return "missing_arg";
+        case ARG_WRONG_TYPE:   return "wrong_type";
+        case ARG_OUT_OF_RANGE: return "out_of_range";
+        default:               return nullptr;
+    }
+}
+
+// Converting one JSON value to an argument type. Numbers must fit the type
+// exactly (3.5 is not an int, 300 is not a uint8_t); `measure` is the value
+// the range is checked against.
+template <typename T>
+struct InventronixArgReader {
+    static bool read(JsonVariantConst value, T& out, double& measure) {
+        if (!value.template is<T>()) return false;
+        out = value.template as<T>();
+        measure = (double)out;
+        return true;
+    }
+};
+
+template <>
+struct InventronixArgReader<const char*> {
+    static bool read(JsonVariantConst value, const char*& out, double& measure) {
+        if (!value.template is<const char*>()) return false;
+        out = value.template as<const char*>();
+        measure = (double)strlen(out);
+        return true;
+    }
+};
+
+template <>
+struct InventronixArgReader<String> {
+    static bool read(JsonVariantConst value, String& out, double& measure) {
+        const char* text = nullptr;
+        if (!InventronixArgReader<const char*>::read(value, text, measure)) return false;
+        out = text;
+        return true;
+    }
+};
+
+// Compile-time index list (std::index_sequence needs C++14)
+template <size_t... I>
+struct InventronixArgIndices {};
+
+template <size_t N, size_t... I>
+struct InventronixMakeArgIndices : InventronixMakeArgIndices<N - 1, N - 1, I...> {};
+
+template <size_t... I>
+struct InventronixMakeArgIndices<0, I...> {
+    typedef InventronixArgIndices<I...> type;
+};
+
+// A handler taking typed arguments. Keys are copied and hashed once at
+// registration; each call walks the command's args once, matching members
+// by hash, then converts and range-checks every value before the handler
+// runs - a malformed command never reaches it.
+template <typename... Args>
+class InventronixTypedCommand {
+public:
+    static const size_t ARG_COUNT = sizeof...(Args);
+    typedef std::function<void(Args...)> Handler;
+
+    InventronixTypedCommand(const ArgSpec (&specs)[ARG_COUNT], Handler handler)
+        : _handler(handler) {
+        for (size_t i = 0; i < ARG_COUNT; i++) {
+            _keys[i] = String(specs[i].key);
+            _hashes[i] = InventronixDispatchIndex::hash(specs[i].key);
+            _specs[i] = specs[i];
+            _specs[i].key = nullptr;   // Caller's string may not outlive registration
+        }
+    }
+
+    // Check `args` and call the handler. Returns ARG_OK, or the first
+    // problem with `badKey` set to the argument concerned.
+    ArgError invoke(JsonObject args, const char*& badKey) const {
+        return invoke(args, badKey, typename InventronixMakeArgIndices<ARG_COUNT>::type());
+    }
+
+private:
+    typedef std::tuple<typename std::decay<Args>::type...> Values;
+
+    template <size_t... I>
+    ArgError invoke(JsonObject args, const char*& badKey, InventronixArgIndices<I...>) const {
+        // One pass over the members; each is compared only with the
+        // expected keys that share its hash
+        JsonVariantConst sources[ARG_COUNT];
+        for (JsonPair member : args) {
+            const char* key = member.key().c_str();
+            uint32_t hash = InventronixDispatchIndex::hash(key);
+            for (size_t i = 0; i < ARG_COUNT; i++) {
+                if (_hashes[i] == hash && _keys[i] == key) {
+                    sources[i] = member.value();
+                    break;
+                }
+            }
+        }
+
+        Values values;
+        ArgError errors[ARG_COUNT] = {readArg(sources[I], _specs[I], std::get<I>(values))...};
+        for (size_t i = 0; i < ARG_COUNT; i++) {
+            if (errors[i] != ARG_OK) {
+                badKey = _keys[i].c_str();
+                return errors[i];
+            }
+        }
+
+        _handler(std::get<I>(values)...);
+        return ARG_OK;
+    }
+
+    template <typename T>
+    static ArgError readArg(JsonVariantConst source, const ArgSpec& spec, T& out) {
+        if (source.isNull()) return ARG_MISSING;
+        double measure = 0;
+        if (!InventronixArgReader<T>::read(source, out, measure)) return ARG_WRONG_TYPE;
+        if (spec.ranged && (measure < spec.minValue || measure > spec.maxValue)) {
+            return ARG_OUT_OF_RANGE;
+        }
+        return ARG_OK;
+    }
+
+    Handler _handler;
+    String _keys[ARG_COUNT];
+    uint32_t _hashes[ARG_COUNT];
+    ArgSpec _specs[ARG_COUNT];
+};
+
+#endif
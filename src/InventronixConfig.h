@@ -3,6 +3,8 @@
 
 // API Configuration
 #define INVENTRONIX_API_BASE_URL "https://api.inventronix.club"
+#define INVENTRONIX_API_HOST "api.inventronix.club"
+#define INVENTRONIX_API_PORT 443
 #define INVENTRONIX_INGEST_ENDPOINT "/v1/iot/ingest"
 
 // Retry Configuration
@@ -13,6 +15,84 @@
 // Request Configuration
 #define INVENTRONIX_HTTP_TIMEOUT 10000  // 10 second timeout
 #define INVENTRONIX_USER_AGENT "Inventronix-Arduino/1.0.0 (ESP32-C3)"
+#define INVENTRONIX_RESPONSE_CHUNK_SIZE 128    // stack bytes per response body read
+
+// Payload Building
+#define INVENTRONIX_TX_BUFFER_SIZE 512         // bytes for beginPayload()
+#define INVENTRONIX_PAYLOAD_FLOAT_DECIMALS 2   // default decimals for Payload::add(float/double) and PayloadTemplate::addFloat
+
+// Payload Templates
+#define INVENTRONIX_TEMPLATE_SIZE 256          // bytes per PayloadTemplate
+#define INVENTRONIX_TEMPLATE_MAX_FIELDS 12
+#define INVENTRONIX_TEMPLATE_NUMBER_WIDTH 12   // default characters per numeric slot
+
+// Command Parsing
+#define INVENTRONIX_PARSE_ARENA_SIZE 2048  // bytes reserved at begin() for response JSON
+
+// Deferred Command Execution
+#define INVENTRONIX_COMMAND_QUEUE_DEPTH 8           // commands waiting for loop()
+#define INVENTRONIX_COMMAND_NAME_LENGTH 32          // max command name length, including terminator
+#define INVENTRONIX_COMMAND_ARGS_SIZE 128           // max serialised arguments per queued command
+#define INVENTRONIX_DEFAULT_COMMAND_BUDGET_US 2000  // loop() time spent on queued commands
+
+// Scheduled Commands (execute_at / delay_ms)
+#define INVENTRONIX_MAX_SCHEDULED_COMMANDS 8   // commands waiting for their time
+#define INVENTRONIX_TIMER_WHEEL_SLOTS 64        // buckets (power of two)
+#define INVENTRONIX_TIMER_WHEEL_TICK_MS 10      // scheduling resolution
+
+// Precision Pulses (RMT on ESP32, GPT one-shot on UNO R4)
+#define INVENTRONIX_PRECISION_PULSE_MAX_MS 60000UL  // longest hardware-timed pulse
+
+// PWM and Ramps (onPwm / onRamp)
+#define INVENTRONIX_DEFAULT_PWM_FREQUENCY 1000  // Hz
+#define INVENTRONIX_PWM_RESOLUTION 10           // duty bits (ESP32 LEDC)
+#define INVENTRONIX_PWM_MAX_STEPS 16            // waveform steps per command
+#define INVENTRONIX_RAMP_UPDATE_MS 10           // how often a ramp moves the duty
+
+// Output Groups (onOutputGroup)
+#define INVENTRONIX_OUTPUT_GROUP_MAX_PINS 32    // one bit per pin in the command bitmap
+#define INVENTRONIX_OUTPUT_GROUP_MAX_PORTS 4    // GPIO banks / ports one group may span
+
+// WiFi Connection (beginWiFi / connectWiFi)
+#define INVENTRONIX_WIFI_ATTEMPT_TIMEOUT_MS 10000   // one join + DHCP attempt
+#define INVENTRONIX_WIFI_RETRY_MIN_MS 1000          // first backoff after a failed attempt
+#define INVENTRONIX_WIFI_RETRY_MAX_MS 30000         // backoff doubles up to this
+#define INVENTRONIX_WIFI_POLL_MS 250                // UNO R4: status polling interval
+#define INVENTRONIX_WIFI_FAST_TIMEOUT_MS 3000       // ESP32: join via cached AP before scanning
+#define INVENTRONIX_WIFI_REUSE_LEASE 1              // ESP32: reuse the last DHCP lease on reconnect
+#define INVENTRONIX_WIFI_LEASE_MAX_AGE_S 1800       // ...for at most this long after DHCP gave it
+#define INVENTRONIX_WIFI_MAX_NETWORKS 4             // addWiFiNetwork() entries
+#define INVENTRONIX_WIFI_MAX_CANDIDATES 8           // access points ranked per scan
+#define INVENTRONIX_WIFI_SCAN_TIMEOUT_MS 10000      // give up on a scan
+#define INVENTRONIX_WIFI_RSSI_POLL_MS 1000          // signal check while connected
+#define INVENTRONIX_WIFI_ROAM_RSSI -75              // roam when weaker than this (dBm, 0 = never)
+#define INVENTRONIX_WIFI_ROAM_HOLD_MS 10000         // ...for this long
+#define INVENTRONIX_WIFI_ROAM_MARGIN_DB 8           // to an access point at least this much stronger
+#define INVENTRONIX_WIFI_ROAM_SCAN_INTERVAL_MS 60000  // between roam scans
+
+// Timer -> loop() Handoff
+#define INVENTRONIX_EVENT_QUEUE_SIZE 32         // pulse events in flight (power of two)
+
+// Idle (loop() / idle())
+#define INVENTRONIX_IDLE_MAX_MS 60000               // loop()'s answer when nothing is due
+#define INVENTRONIX_LIGHT_SLEEP_MIN_MS 10           // ESP32: shorter waits skip light sleep
+
+// Duplicate Command Suppression
+#define INVENTRONIX_DEDUP_CACHE_SIZE 16         // recent execution_ids remembered
+#define INVENTRONIX_DEFAULT_DEDUP_TTL 600000UL  // 10 minutes (0 = never expire)
+
+// Command Acknowledgements (sent with the next ingest request)
+#define INVENTRONIX_ACK_FIELD "_acks"          // payload key carrying the acks
+#define INVENTRONIX_ACK_BUFFER_SIZE 8          // pending acks kept between requests
+#define INVENTRONIX_EXECUTION_ID_LENGTH 48     // max execution_id length, including terminator
+#define INVENTRONIX_ACK_RESULT_LENGTH 32       // max result length, including terminator
+
+// Deep-Sleep Duty Cycle (runDutyCycle)
+#define INVENTRONIX_SAMPLES_FIELD "_samples"        // payload key carrying older samples
+#define INVENTRONIX_CYCLE_FIELD "_cycle"            // payload key carrying last cycle's timings
+#define INVENTRONIX_DUTY_SAMPLE_BYTES 2048          // RTC memory for samples awaiting upload
+#define INVENTRONIX_DUTY_CONNECT_TIMEOUT_MS 8000    // give up on WiFi for this cycle
+#define INVENTRONIX_DUTY_MAX_AWAKE_MS 20000         // longest a cycle waits for pulses/commands
 
 // Logging
 #define INVENTRONIX_VERBOSE_LOGGING true
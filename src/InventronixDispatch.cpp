@@ -0,0 +1,83 @@
+#include "InventronixDispatch.h"
+#include <stdlib.h>
+
+static const size_t DISPATCH_MIN_CAPACITY = 16;
+
+InventronixDispatchIndex::InventronixDispatchIndex()
+    : _entries(nullptr), _capacity(0), _count(0) {
+}
+
+InventronixDispatchIndex::~InventronixDispatchIndex() {
+    free(_entries);
+}
+
+// FNV-1a, 32-bit
+uint32_t InventronixDispatchIndex::hash(const char* name) {
+    uint32_t h = 2166136261UL;
+    while (*name != '\0') {
+        h ^= (uint8_t)*name++;
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+bool InventronixDispatchIndex::insert(uint32_t hash, uint16_t value) {
+    if ((_count + 1) * 2 > _capacity) {
+        size_t capacity = (_capacity == 0) ? DISPATCH_MIN_CAPACITY : _capacity * 2;
+        if (!grow(capacity)) {
+            return false;
+        }
+    }
+
+    // Linear probing keeps insertion order along a probe chain, so find()
+    // returns the earliest registration for a name
+    size_t mask = _capacity - 1;
+    size_t i = hash & mask;
+    while (_entries[i].used) {
+        i = (i + 1) & mask;
+    }
+    _entries[i].hash = hash;
+    _entries[i].value = value;
+    _entries[i].used = 1;
+    _count++;
+    return true;
+}
+
+void InventronixDispatchIndex::clear() {
+    for (size_t i = 0; i < _capacity; i++) {
+        _entries[i].used = 0;
+    }
+    _count = 0;
+}
+
+bool InventronixDispatchIndex::grow(size_t capacity) {
+    Entry* entries = (Entry*)calloc(capacity, sizeof(Entry));
+    if (entries == nullptr) {
+        return false;
+    }
+
+    // Re-insert in table order; entries sharing a hash keep their relative order
+    Entry* old = _entries;
+    size_t oldCapacity = _capacity;
+    size_t mask = capacity - 1;
+    size_t start = 0;
+
+    // Begin at an empty slot so wrapped probe chains are re-inserted in order
+    while (start < oldCapacity && old[start].used) {
+        start++;
+    }
+    for (size_t n = 0; n < oldCapacity; n++) {
+        const Entry& e = old[(start + n) % oldCapacity];
+        if (!e.used) continue;
+        size_t i = e.hash & mask;
+        while (entries[i].used) {
+            i = (i + 1) & mask;
+        }
+        entries[i] = e;
+    }
+
+    free(old);
+    _entries = entries;
+    _capacity = capacity;
+    return true;
+}
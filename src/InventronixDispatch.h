@@ -0,0 +1,57 @@
+#ifndef INVENTRONIX_DISPATCH_H
+#define INVENTRONIX_DISPATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Open-addressing hash index from a name hash (FNV-1a, 32-bit) to a small
+// handler value. Built at registration time; lookups cost one hash of the
+// incoming name plus a short linear probe, and a match is confirmed by the
+// caller's predicate so hash collisions never dispatch the wrong handler.
+class InventronixDispatchIndex {
+public:
+    InventronixDispatchIndex();
+    ~InventronixDispatchIndex();
+
+    static uint32_t hash(const char* name);
+
+    // Add an entry, growing the table to keep the load factor at most 1/2.
+    // Returns false if memory for the table could not be allocated.
+    bool insert(uint32_t hash, uint16_t value);
+
+    // First value (in insertion order) with this hash that satisfies
+    // `match(value)`, or -1.
+    template <typename Match>
+    int find(uint32_t hash, Match match) const {
+        if (_capacity == 0) return -1;
+        size_t mask = _capacity - 1;
+        for (size_t i = hash & mask; _entries[i].used; i = (i + 1) & mask) {
+            if (_entries[i].hash == hash && match(_entries[i].value)) {
+                return _entries[i].value;
+            }
+        }
+        return -1;
+    }
+
+    void clear();
+    size_t count() const { return _count; }
+    size_t capacity() const { return _capacity; }
+
+private:
+    struct Entry {
+        uint32_t hash;
+        uint16_t value;
+        uint16_t used;
+    };
+
+    Entry* _entries;
+    size_t _capacity;   // Always a power of two (or 0)
+    size_t _count;
+
+    bool grow(size_t capacity);
+
+    InventronixDispatchIndex(const InventronixDispatchIndex&) = delete;
+    InventronixDispatchIndex& operator=(const InventronixDispatchIndex&) = delete;
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef INVENTRONIX_EVENT_QUEUE_H
+#define INVENTRONIX_EVENT_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+// Lock-free single-producer / single-consumer ring buffer.
+//
+// One context (a timer task or interrupt) pushes, another (loop()) pops;
+// neither ever blocks or takes a lock. The producer owns `_tail` and the
+// consumer owns `_head`: each index is written by one side only, and the
+// release/acquire pair on it publishes the slot contents to the other side.
+// N must be a power of two.
+template <typename T, uint32_t N>
+class InventronixEventQueue {
+public:
+    InventronixEventQueue() : _head(0), _tail(0) {}
+
+    // Producer: append an item. Returns false (and drops it) if full.
+    bool push(const T& item) {
+        uint32_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head.load(std::memory_order_acquire) >= N) {
+            return false;
+        }
+        _items[tail & (N - 1)] = item;
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer: free slots (may grow, never shrink, while the consumer runs)
+    uint32_t space() const {
+        return N - (_tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_acquire));
+    }
+
+    // Consumer: take the oldest item. Returns false if empty.
+    bool pop(T& item) {
+        uint32_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = _items[head & (N - 1)];
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return _head.load(std::memory_order_relaxed) == _tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static_assert((N & (N - 1)) == 0, "queue size must be a power of two");
+
+    T _items[N];
+    std::atomic<uint32_t> _head;
+    std::atomic<uint32_t> _tail;
+};
+
+#endif
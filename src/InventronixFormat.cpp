@@ -0,0 +1,543 @@
+#include "InventronixFormat.h"
+#include <math.h>
+#include <string.h>
+
+// "00" to "99" - lets us emit two digits per division
+static const char DIGIT_PAIRS[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint32_t POW10[10] = {
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL,
+    1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
+static const float POW10F[10] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f
+};
+
+// Write the digits of `value` backwards, ending just before `end`
+static char* writeDigitsBackwards(char* end, uint32_t value) {
+    while (value >= 100) {
+        uint32_t pair = (value % 100) * 2;
+        value /= 100;
+        *--end = DIGIT_PAIRS[pair + 1];
+        *--end = DIGIT_PAIRS[pair];
+    }
+    if (value >= 10) {
+        *--end = DIGIT_PAIRS[value * 2 + 1];
+        *--end = DIGIT_PAIRS[value * 2];
+    } else {
+        *--end = (char)('0' + value);
+    }
+    return end;
+}
+
+static size_t finish(char* out, const char* start, const char* end) {
+    size_t len = end - start;
+    memmove(out, start, len);
+    out[len] = '\0';
+    return len;
+}
+
+size_t InventronixFormat::formatUInt(char* out, uint32_t value) {
+    char tmp[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    char* end = tmp + sizeof(tmp);
+    return finish(out, writeDigitsBackwards(end, value), end);
+}
+
+size_t InventronixFormat::formatInt(char* out, int32_t value) {
+    if (value < 0) {
+        out[0] = '-';
+        return 1 + formatUInt(out + 1, 0U - (uint32_t)value);
+    }
+    return formatUInt(out, (uint32_t)value);
+}
+
+size_t InventronixFormat::formatUInt64(char* out, uint64_t value) {
+    if (value <= 0xFFFFFFFFULL) {
+        return formatUInt(out, (uint32_t)value);
+    }
+
+    // Split into 9-digit chunks so the inner loop stays in 32-bit arithmetic
+    char tmp[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    char* end = tmp + sizeof(tmp);
+    char* p = end;
+    while (value > 0xFFFFFFFFULL) {
+        uint32_t chunk = (uint32_t)(value % 1000000000ULL);
+        value /= 1000000000ULL;
+        char* chunkEnd = p;
+        p = writeDigitsBackwards(p, chunk);
+        while (chunkEnd - p < 9) {
+            *--p = '0';
+        }
+    }
+    p = writeDigitsBackwards(p, (uint32_t)value);
+    return finish(out, p, end);
+}
+
+size_t InventronixFormat::formatInt64(char* out, int64_t value) {
+    if (value < 0) {
+        out[0] = '-';
+        return 1 + formatUInt64(out + 1, 0ULL - (uint64_t)value);
+    }
+    return formatUInt64(out, (uint64_t)value);
+}
+
+static const double POW10D[10] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+};
+
+static float floorValue(float value) { return floorf(value); }
+static double floorValue(double value) { return floor(value); }
+
+// Shared by formatFloat and formatDouble so each stays in its own precision
+// (float math is hardware on most targets, double is always emulated)
+template <typename T>
+static size_t formatDecimal(char* out, T value, uint8_t decimals, const T* pow10) {
+    if (isnan(value) || isinf(value)) {
+        memcpy(out, "null", 5);
+        return 4;
+    }
+    if (decimals > 9) {
+        decimals = 9;
+    }
+
+    size_t len = 0;
+    if (value < 0) {
+        out[len++] = '-';
+        value = -value;
+    }
+
+    // Beyond uint64: emit the leading digits and an exponent
+    if (value >= (T)1.8e19) {
+        int exponent = 0;
+        while (value >= (T)1e9) {
+            value /= (T)10;
+            exponent++;
+        }
+        len += InventronixFormat::formatUInt(out + len, (uint32_t)(value + (T)0.5));
+        out[len++] = 'e';
+        len += InventronixFormat::formatUInt(out + len, exponent);
+        return len;
+    }
+
+    // Split before scaling so large values keep every integer digit
+    T integerT = floorValue(value);
+    uint64_t integerPart = (uint64_t)integerT;
+    uint32_t fraction = (uint32_t)((value - integerT) * pow10[decimals] + (T)0.5);
+    if (fraction >= POW10[decimals]) {
+        integerPart++;
+        fraction -= POW10[decimals];
+    }
+    len += InventronixFormat::formatUInt64(out + len, integerPart);
+
+    if (decimals > 0) {
+        out[len++] = '.';
+        char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+        size_t n = InventronixFormat::formatUInt(digits, fraction);
+        for (size_t i = n; i < decimals; i++) {
+            out[len++] = '0';
+        }
+        memcpy(out + len, digits, n);
+        len += n;
+    }
+
+    // Negative zero after rounding is just zero
+    if (out[0] == '-' && integerPart == 0 && fraction == 0) {
+        memmove(out, out + 1, len);
+        len--;
+    }
+
+    out[len] = '\0';
+    return len;
+}
+
+size_t InventronixFormat::formatFloat(char* out, float value, uint8_t decimals) {
+    return formatDecimal(out, value, decimals, POW10F);
+}
+
+size_t InventronixFormat::formatDouble(char* out, double value, uint8_t decimals) {
+    return formatDecimal(out, value, decimals, POW10D);
+}
+
+size_t InventronixFormat::formatFixed(char* out, int32_t raw, uint8_t scale, uint8_t decimals) {
+    if (scale > 9) scale = 9;
+    if (decimals > 9) decimals = 9;
+
+    size_t len = 0;
+    uint32_t magnitude = (raw < 0) ? 0U - (uint32_t)raw : (uint32_t)raw;
+
+    // Drop surplus digits with round-half-away-from-zero
+    if (decimals < scale) {
+        uint32_t divisor = POW10[scale - decimals];
+        uint32_t remainder = magnitude % divisor;
+        magnitude /= divisor;
+        if (remainder >= divisor - remainder) {
+            magnitude++;
+        }
+        scale = decimals;
+    }
+
+    if (raw < 0 && magnitude != 0) {
+        out[len++] = '-';
+    }
+
+    uint32_t integerPart = magnitude / POW10[scale];
+    uint32_t fraction = magnitude % POW10[scale];
+    len += formatUInt(out + len, integerPart);
+
+    if (decimals > 0) {
+        out[len++] = '.';
+        if (scale > 0) {
+            char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+            size_t n = formatUInt(digits, fraction);
+            for (size_t i = n; i < scale; i++) {
+                out[len++] = '0';
+            }
+            memcpy(out + len, digits, n);
+            len += n;
+        }
+        // Pad when showing more decimals than the raw value carries
+        for (uint8_t i = scale; i < decimals; i++) {
+            out[len++] = '0';
+        }
+    }
+
+    out[len] = '\0';
+    return len;
+}
+
+int32_t InventronixFormat::toFixed(float value, uint8_t scale) {
+    if (scale > 9) scale = 9;
+    float scaled = value * POW10F[scale];
+    if (isnan(scaled)) return 0;
+    if (scaled >= 2147483647.0f) return INT32_MAX;
+    if (scaled <= -2147483648.0f) return INT32_MIN;
+    return (int32_t)(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+}
+
+// ============================================
+// SHORTEST ROUND-TRIP FLOAT
+// ============================================
+//
+// Steele & White / Burger & Dybvig free-format digit generation on small
+// fixed-size bignums. A float32 never needs more than ~140 bits here, so
+// every operation is a handful of 32-bit word ops - no FPU, no division.
+
+namespace {
+
+const int BIGNUM_WORDS = 6;
+
+struct Bignum {
+    uint32_t words[BIGNUM_WORDS];
+    int used;   // Number of significant words
+
+    void set(uint32_t value) {
+        words[0] = value;
+        used = (value != 0) ? 1 : 0;
+    }
+
+    void shiftLeft(int bits) {
+        if (used == 0) return;
+        int wordShift = bits / 32;
+        int bitShift = bits % 32;
+        uint32_t shifted[BIGNUM_WORDS] = {0};
+        for (int i = 0; i < used; i++) {
+            uint64_t v = (uint64_t)words[i] << bitShift;
+            if (i + wordShift < BIGNUM_WORDS) shifted[i + wordShift] |= (uint32_t)v;
+            if (i + wordShift + 1 < BIGNUM_WORDS) shifted[i + wordShift + 1] |= (uint32_t)(v >> 32);
+        }
+        memcpy(words, shifted, sizeof(words));
+        used += wordShift + 1;
+        if (used > BIGNUM_WORDS) used = BIGNUM_WORDS;
+        trim();
+    }
+
+    void multiply(uint32_t factor) {
+        uint64_t carry = 0;
+        for (int i = 0; i < used; i++) {
+            uint64_t v = (uint64_t)words[i] * factor + carry;
+            words[i] = (uint32_t)v;
+            carry = v >> 32;
+        }
+        if (carry != 0 && used < BIGNUM_WORDS) {
+            words[used++] = (uint32_t)carry;
+        }
+    }
+
+    void multiplyPow10(int exponent) {
+        while (exponent >= 9) {
+            multiply(1000000000UL);
+            exponent -= 9;
+        }
+        if (exponent > 0) {
+            multiply(POW10[exponent]);
+        }
+    }
+
+    void trim() {
+        while (used > 0 && words[used - 1] == 0) {
+            used--;
+        }
+    }
+};
+
+int compare(const Bignum& a, const Bignum& b) {
+    if (a.used != b.used) return a.used < b.used ? -1 : 1;
+    for (int i = a.used - 1; i >= 0; i--) {
+        if (a.words[i] != b.words[i]) return a.words[i] < b.words[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// Compare a + b against c without materialising the sum
+int compareSum(const Bignum& a, const Bignum& b, const Bignum& c) {
+    Bignum sum;
+    int n = a.used > b.used ? a.used : b.used;
+    uint64_t carry = 0;
+    for (int i = 0; i < n; i++) {
+        uint64_t v = carry;
+        if (i < a.used) v += a.words[i];
+        if (i < b.used) v += b.words[i];
+        sum.words[i] = (uint32_t)v;
+        carry = v >> 32;
+    }
+    sum.used = n;
+    if (carry != 0) {
+        if (n >= BIGNUM_WORDS) return 1;
+        sum.words[sum.used++] = (uint32_t)carry;
+    }
+    return compare(sum, c);
+}
+
+// a -= b (requires a >= b)
+void subtract(Bignum& a, const Bignum& b) {
+    int64_t borrow = 0;
+    for (int i = 0; i < a.used; i++) {
+        int64_t v = (int64_t)a.words[i] - (i < b.used ? b.words[i] : 0) - borrow;
+        borrow = v < 0 ? 1 : 0;
+        a.words[i] = (uint32_t)(v + (borrow << 32));
+    }
+    a.trim();
+}
+
+// Same interface as Bignum for values that fit a machine word - most sensor
+// readings (roughly 1e-7 to 1e6) never need more than 64 bits
+struct SmallNum {
+    uint64_t value;
+
+    void set(uint32_t v) { value = v; }
+    void shiftLeft(int bits) { value <<= bits; }
+    void multiply(uint32_t factor) { value *= factor; }
+    void multiplyPow10(int exponent) {
+        while (exponent-- > 0) value *= 10;
+    }
+};
+
+inline int compare(const SmallNum& a, const SmallNum& b) {
+    return a.value < b.value ? -1 : (a.value > b.value ? 1 : 0);
+}
+
+inline int compareSum(const SmallNum& a, const SmallNum& b, const SmallNum& c) {
+    uint64_t sum = a.value + b.value;
+    return sum < c.value ? -1 : (sum > c.value ? 1 : 0);
+}
+
+inline void subtract(SmallNum& a, const SmallNum& b) {
+    a.value -= b.value;
+}
+
+int bitLength(uint32_t v) {
+    int n = 0;
+    while (v != 0) {
+        n++;
+        v >>= 1;
+    }
+    return n;
+}
+
+// Free-format digit generation for value = mantissa * 2^exponent.
+// Writes up to 9 digits and returns their count; `k` receives the decimal
+// exponent such that value = 0.digits * 10^k.
+template <typename Num>
+int shortestDigits(uint32_t mantissa, int exponent, bool unequalGaps, int kEstimate,
+                   char* digits, int& k) {
+    bool inclusive = (mantissa & 1) == 0;   // Ties round to even
+
+    // value = r / s; the rounding interval is (value - mMinus/s, value + mPlus/s)
+    Num r, s, mPlus, mMinus;
+    if (exponent >= 0) {
+        r.set(mantissa);
+        r.shiftLeft(exponent + (unequalGaps ? 2 : 1));
+        s.set(unequalGaps ? 4 : 2);
+        mPlus.set(1);
+        mPlus.shiftLeft(exponent + (unequalGaps ? 1 : 0));
+        mMinus.set(1);
+        mMinus.shiftLeft(exponent);
+    } else {
+        r.set(mantissa);
+        r.shiftLeft(unequalGaps ? 2 : 1);
+        s.set(1);
+        s.shiftLeft(-exponent + (unequalGaps ? 2 : 1));
+        mPlus.set(unequalGaps ? 2 : 1);
+        mMinus.set(1);
+    }
+
+    k = kEstimate;
+    if (k >= 0) {
+        s.multiplyPow10(k);
+    } else {
+        r.multiplyPow10(-k);
+        mPlus.multiplyPow10(-k);
+        mMinus.multiplyPow10(-k);
+    }
+
+    // Fix up the estimate so that value / 10^k lies in [0.1, 1)
+    for (;;) {
+        int high = compareSum(r, mPlus, s);
+        if (inclusive ? high < 0 : high <= 0) break;
+        s.multiply(10);
+        k++;
+    }
+    for (;;) {
+        Num r10 = r, mPlus10 = mPlus;
+        r10.multiply(10);
+        mPlus10.multiply(10);
+        int check = compareSum(r10, mPlus10, s);
+        if (inclusive ? check >= 0 : check > 0) break;
+        r = r10;
+        mPlus = mPlus10;
+        mMinus.multiply(10);
+        k--;
+    }
+
+    // Generate digits until the remainder is inside the rounding interval
+    int count = 0;
+    for (;;) {
+        r.multiply(10);
+        mPlus.multiply(10);
+        mMinus.multiply(10);
+
+        int digit = 0;
+        while (compare(r, s) >= 0) {
+            subtract(r, s);
+            digit++;
+        }
+
+        int low = compare(r, mMinus);
+        int high = compareSum(r, mPlus, s);
+        bool tc1 = inclusive ? low <= 0 : low < 0;
+        bool tc2 = inclusive ? high >= 0 : high > 0;
+
+        if (!tc1 && !tc2 && count < 8) {
+            digits[count++] = (char)('0' + digit);
+            continue;
+        }
+        if (tc1 && tc2) {
+            // Both candidates round-trip; pick the closer one
+            Num twice = r;
+            twice.shiftLeft(1);
+            if (compare(twice, s) >= 0) digit++;
+        } else if (tc2) {
+            digit++;
+        }
+        digits[count++] = (char)('0' + digit);
+        return count;
+    }
+}
+
+}  // namespace
+
+size_t InventronixFormat::formatFloatShortest(char* out, float value) {
+    if (isnan(value) || isinf(value)) {
+        memcpy(out, "null", 5);
+        return 4;
+    }
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    size_t len = 0;
+    if (bits >> 31) {
+        out[len++] = '-';
+    }
+
+    uint32_t biasedExponent = (bits >> 23) & 0xFF;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (biasedExponent == 0 && mantissa == 0) {
+        out[0] = '0';   // Drop the sign of -0
+        out[1] = '\0';
+        return 1;
+    }
+
+    int exponent;
+    if (biasedExponent == 0) {
+        exponent = -149;            // Subnormal
+    } else {
+        mantissa |= 0x800000;
+        exponent = (int)biasedExponent - 150;
+    }
+
+    // Small integers: no digit generation needed
+    if (exponent >= 0 && exponent <= 7 && (mantissa << exponent) < (1UL << 31)) {
+        return len + formatUInt(out + len, mantissa << exponent);
+    }
+    if (exponent < 0 && exponent > -24 && (mantissa & ((1UL << -exponent) - 1)) == 0) {
+        return len + formatUInt(out + len, mantissa >> -exponent);
+    }
+
+    // Estimate k = ceil(log10(value)) from the binary exponent (1233/4096 ~ log10(2))
+    bool unequalGaps = (mantissa == 0x800000 && biasedExponent > 1);
+    int log2Value = exponent + bitLength(mantissa) - 1;
+    int kEstimate = (log2Value >= 0) ? ((log2Value * 1233) >> 12) + 1 : -((-log2Value * 1233) >> 12);
+
+    // Bits needed for s, plus headroom for the fix-up and digit loop (x100)
+    int sBits = (exponent < 0 ? 2 - exponent : 3) + (kEstimate > 0 ? (kEstimate * 3322 + 999) / 1000 : 0);
+    bool fitsWord = exponent < 0 && sBits + 8 <= 63 && 25 + 4 * (kEstimate < 0 ? -kEstimate : 0) <= 55;
+
+    char digits[12];
+    int k;
+    int count = fitsWord
+        ? shortestDigits<SmallNum>(mantissa, exponent, unequalGaps, kEstimate, digits, k)
+        : shortestDigits<Bignum>(mantissa, exponent, unequalGaps, kEstimate, digits, k);
+
+    // value = 0.digits * 10^k; pick plain or exponent notation
+    if (k > 0 && k <= 9) {
+        for (int i = 0; i < k; i++) {
+            out[len++] = (i < count) ? digits[i] : '0';
+        }
+        if (count > k) {
+            out[len++] = '.';
+            for (int i = k; i < count; i++) out[len++] = digits[i];
+        }
+    } else if (k <= 0 && k > -5) {
+        out[len++] = '0';
+        out[len++] = '.';
+        for (int i = 0; i < -k; i++) out[len++] = '0';
+        for (int i = 0; i < count; i++) out[len++] = digits[i];
+    } else {
+        out[len++] = digits[0];
+        if (count > 1) {
+            out[len++] = '.';
+            for (int i = 1; i < count; i++) out[len++] = digits[i];
+        }
+        out[len++] = 'e';
+        int exp10 = k - 1;
+        if (exp10 < 0) {
+            out[len++] = '-';
+            exp10 = -exp10;
+        }
+        len += formatUInt(out + len, (uint32_t)exp10);
+    }
+
+    out[len] = '\0';
+    return len;
+}
@@ -0,0 +1,42 @@
+#ifndef INVENTRONIX_FORMAT_H
+#define INVENTRONIX_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Largest string any formatter below can produce, including the terminator
+#define INVENTRONIX_NUMBER_BUFFER_SIZE 32
+
+// Allocation-free number formatting for payload building.
+// Every function writes a NUL-terminated string into `out` (which must hold
+// INVENTRONIX_NUMBER_BUFFER_SIZE bytes) and returns its length.
+//
+// The fixed-point and shortest-float routines use integer arithmetic only,
+// so they stay fast on cores without an FPU (e.g. ESP32-C3).
+class InventronixFormat {
+public:
+    static size_t formatUInt(char* out, uint32_t value);
+    static size_t formatInt(char* out, int32_t value);
+    static size_t formatUInt64(char* out, uint64_t value);
+    static size_t formatInt64(char* out, int64_t value);
+
+    // Float rounded to a fixed number of decimals (0-9). NaN/Inf become "null".
+    static size_t formatFloat(char* out, float value, uint8_t decimals);
+
+    // Same for doubles, computed in double precision so values past float's
+    // 24-bit mantissa (e.g. epoch seconds) keep every integer digit
+    static size_t formatDouble(char* out, double value, uint8_t decimals);
+
+    // Fixed-point: `raw` is the value scaled by 10^scale (2350 with scale 2
+    // is 23.50). Rounded half away from zero, or zero-padded, to `decimals`.
+    static size_t formatFixed(char* out, int32_t raw, uint8_t scale, uint8_t decimals);
+
+    // Shortest decimal that parses back to exactly `value`
+    // (23.5f -> "23.5", 0.1f -> "0.1", 3e38f -> "3e38"). NaN/Inf become "null".
+    static size_t formatFloatShortest(char* out, float value);
+
+    // Nearest fixed-point raw value for a float (value * 10^scale)
+    static int32_t toFixed(float value, uint8_t scale);
+};
+
+#endif
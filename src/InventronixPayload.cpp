@@ -0,0 +1,187 @@
+#include "InventronixPayload.h"
+#include "InventronixConfig.h"
+#include "InventronixFormat.h"
+#include <string.h>
+
+InventronixPayload::InventronixPayload(char* buffer, size_t capacity)
+    : _buffer(buffer), _capacity(capacity) {
+    clear();
+}
+
+InventronixPayload& InventronixPayload::clear() {
+    _length = 0;
+    _fields = 0;
+    _overflowed = false;
+
+    // Smallest valid payload is "{}"
+    if (_capacity < 3) {
+        _overflowed = true;
+        if (_capacity > 0) _buffer[0] = '\0';
+        return *this;
+    }
+    _buffer[_length++] = '{';
+    _buffer[_length] = '}';
+    _buffer[_length + 1] = '\0';
+    return *this;
+}
+
+InventronixPayload& InventronixPayload::add(const char* key, int value) {
+    return add(key, (long)value);
+}
+
+InventronixPayload& InventronixPayload::add(const char* key, unsigned int value) {
+    return add(key, (unsigned long)value);
+}
+
+InventronixPayload& InventronixPayload::add(const char* key, long value) {
+    char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    size_t n = (sizeof(long) <= 4) ? InventronixFormat::formatInt(digits, (int32_t)value)
+                                   : InventronixFormat::formatInt64(digits, (int64_t)value);
+    return addRaw(key, digits, n, false);
+}
+
+InventronixPayload& InventronixPayload::add(const char* key, unsigned long value) {
+    char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    size_t n = (sizeof(long) <= 4) ? InventronixFormat::formatUInt(digits, (uint32_t)value)
+                                   : InventronixFormat::formatUInt64(digits, (uint64_t)value);
+    return addRaw(key, digits, n, false);
+}
+
+// Floats without explicit decimals get INVENTRONIX_PAYLOAD_FLOAT_DECIMALS
+InventronixPayload& InventronixPayload::add(const char* key, float value) {
+    return add(key, value, (uint8_t)INVENTRONIX_PAYLOAD_FLOAT_DECIMALS);
+}
+
+InventronixPayload& InventronixPayload::add(const char* key, long long value) {
+    char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    size_t n = InventronixFormat::formatInt64(digits, (int64_t)value);
+    return addRaw(key, digits, n, false);
+}
+
+InventronixPayload& InventronixPayload::add(const char* key, unsigned long long value) {
+    char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    size_t n = InventronixFormat::formatUInt64(digits, (uint64_t)value);
+    return addRaw(key, digits, n, false);
+}
+
+// Doubles stay doubles - narrowing 1760702400.0 to float would send 1760702464
+InventronixPayload& InventronixPayload::add(const char* key, double value) {
+    return add(key, value, (uint8_t)INVENTRONIX_PAYLOAD_FLOAT_DECIMALS);
+}
+
+InventronixPayload& InventronixPayload::add(const char* key, float value, uint8_t decimals) {
+    char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    size_t n = InventronixFormat::formatFloat(digits, value, decimals);
+    return addRaw(key, digits, n, false);
+}
+
+InventronixPayload& InventronixPayload::add(const char* key, double value, uint8_t decimals) {
+    char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    size_t n = InventronixFormat::formatDouble(digits, value, decimals);
+    return addRaw(key, digits, n, false);
+}
+
+// Slower than fixed decimals - only for fields that must read back exactly
+InventronixPayload& InventronixPayload::addShortest(const char* key, float value) {
+    char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    size_t n = InventronixFormat::formatFloatShortest(digits, value);
+    return addRaw(key, digits, n, false);
+}
+
+InventronixPayload& InventronixPayload::addFixed(const char* key, int32_t raw, uint8_t scale) {
+    return addFixed(key, raw, scale, scale);
+}
+
+InventronixPayload& InventronixPayload::addFixed(const char* key, int32_t raw, uint8_t scale, uint8_t decimals) {
+    char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    size_t n = InventronixFormat::formatFixed(digits, raw, scale, decimals);
+    return addRaw(key, digits, n, false);
+}
+
+InventronixPayload& InventronixPayload::add(const char* key, bool value) {
+    return value ? addRaw(key, "true", 4, false) : addRaw(key, "false", 5, false);
+}
+
+InventronixPayload& InventronixPayload::add(const char* key, const char* value) {
+    if (value == nullptr) {
+        return addRaw(key, "null", 4, false);
+    }
+    return addRaw(key, value, 0, true);
+}
+
+// Append `"key":value` and re-close the object. On overflow the buffer is
+// rolled back to the previous field so it stays valid JSON.
+InventronixPayload& InventronixPayload::addRaw(const char* key, const char* value,
+                                               size_t valueLength, bool quoted) {
+    if (_capacity < 3) {
+        _overflowed = true;
+        return *this;
+    }
+
+    size_t pos = _length;
+    bool ok = true;
+    if (_fields > 0) {
+        ok = append(pos, ",", 1);
+    }
+    ok = ok && append(pos, "\"", 1) && appendEscaped(pos, key) && append(pos, "\":", 2);
+    if (quoted) {
+        ok = ok && append(pos, "\"", 1) && appendEscaped(pos, value) && append(pos, "\"", 1);
+    } else {
+        ok = ok && append(pos, value, valueLength);
+    }
+
+    // Room for the closing brace and terminator
+    if (!ok || pos + 2 > _capacity) {
+        _overflowed = true;
+        _buffer[_length] = '}';
+        _buffer[_length + 1] = '\0';
+        return *this;
+    }
+
+    _length = pos;
+    _fields++;
+    _buffer[_length] = '}';
+    _buffer[_length + 1] = '\0';
+    return *this;
+}
+
+bool InventronixPayload::append(size_t& pos, const char* text, size_t length) {
+    if (pos + length + 2 > _capacity) {
+        return false;
+    }
+    memcpy(_buffer + pos, text, length);
+    pos += length;
+    return true;
+}
+
+bool InventronixPayload::appendEscaped(size_t& pos, const char* text) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+
+    for (const char* p = text; *p != '\0'; p++) {
+        unsigned char c = (unsigned char)*p;
+        char escaped[6];
+        size_t n = 0;
+
+        if (c == '"' || c == '\\') {
+            escaped[n++] = '\\';
+            escaped[n++] = (char)c;
+        } else if (c == '\n') {
+            escaped[n++] = '\\';
+            escaped[n++] = 'n';
+        } else if (c < 0x20) {
+            escaped[n++] = '\\';
+            escaped[n++] = 'u';
+            escaped[n++] = '0';
+            escaped[n++] = '0';
+            escaped[n++] = HEX_DIGITS[c >> 4];
+            escaped[n++] = HEX_DIGITS[c & 0x0F];
+        } else {
+            escaped[n++] = (char)c;
+        }
+
+        if (!append(pos, escaped, n)) {
+            return false;
+        }
+    }
+    return true;
+}
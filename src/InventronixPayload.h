@@ -0,0 +1,66 @@
+#ifndef INVENTRONIX_PAYLOAD_H
+#define INVENTRONIX_PAYLOAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Builds a flat JSON object directly into a caller-owned buffer.
+// No JsonDocument, no String, no heap - values are formatted in place and
+// the buffer is always a valid, closed JSON object.
+//
+//   Inventronix::Payload& payload = inventronix.beginPayload();
+//   payload.add("temperature", 23.5).add("heater_on", true);
+//   inventronix.sendPayload(payload);
+class InventronixPayload {
+public:
+    InventronixPayload(char* buffer, size_t capacity);
+
+    // Start a new, empty object
+    InventronixPayload& clear();
+
+    InventronixPayload& add(const char* key, int value);
+    InventronixPayload& add(const char* key, unsigned int value);
+    InventronixPayload& add(const char* key, long value);
+    InventronixPayload& add(const char* key, unsigned long value);
+    InventronixPayload& add(const char* key, long long value);
+    InventronixPayload& add(const char* key, unsigned long long value);
+    InventronixPayload& add(const char* key, float value);
+    InventronixPayload& add(const char* key, double value);
+    InventronixPayload& add(const char* key, bool value);
+    InventronixPayload& add(const char* key, const char* value);
+
+    // Float with an explicit number of decimals (add(key, float) uses
+    // INVENTRONIX_PAYLOAD_FLOAT_DECIMALS)
+    InventronixPayload& add(const char* key, float value, uint8_t decimals);
+    InventronixPayload& add(const char* key, double value, uint8_t decimals);
+
+    // Float with the shortest digits that read back as the same value
+    // (0.1f -> 0.1, 3e38f -> 3e38). Several times slower than fixed decimals.
+    InventronixPayload& addShortest(const char* key, float value);
+
+    // Fixed-point integer: `raw` is the value scaled by 10^scale, written
+    // with `decimals` digits after the point using integer math only
+    // (addFixed("temperature", 2350, 2) -> "temperature":23.50)
+    InventronixPayload& addFixed(const char* key, int32_t raw, uint8_t scale);
+    InventronixPayload& addFixed(const char* key, int32_t raw, uint8_t scale, uint8_t decimals);
+
+    // True if any add() did not fit - the field was dropped
+    bool overflowed() const { return _overflowed; }
+
+    const char* c_str() const { return _buffer; }
+    size_t length() const { return _length + 1; }  // Includes the closing brace
+    size_t capacity() const { return _capacity; }
+
+private:
+    char* _buffer;
+    size_t _capacity;
+    size_t _length;     // Bytes before the closing brace
+    size_t _fields;
+    bool _overflowed;
+
+    InventronixPayload& addRaw(const char* key, const char* value, size_t valueLength, bool quoted);
+    bool append(size_t& pos, const char* text, size_t length);
+    bool appendEscaped(size_t& pos, const char* text);
+};
+
+#endif
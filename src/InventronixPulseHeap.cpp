@@ -0,0 +1,164 @@
+#include "InventronixPulseHeap.h"
+#include <stdlib.h>
+#include <string.h>
+
+InventronixPulseHeap::InventronixPulseHeap()
+    : _entries(nullptr), _position(nullptr), _count(0), _capacity(0) {
+}
+
+InventronixPulseHeap::~InventronixPulseHeap() {
+    free(_entries);
+    free(_position);
+}
+
+bool InventronixPulseHeap::reserve(int ids) {
+    if (ids <= _capacity) {
+        return true;
+    }
+
+    // Grow geometrically so registering n pulses costs O(n) overall
+    int capacity = (_capacity > 0) ? _capacity : 4;
+    while (capacity < ids) {
+        capacity *= 2;
+    }
+
+    Entry* entries = (Entry*)realloc(_entries, capacity * sizeof(Entry));
+    if (entries == nullptr) {
+        return false;
+    }
+    _entries = entries;
+
+    int* position = (int*)realloc(_position, capacity * sizeof(int));
+    if (position == nullptr) {
+        return false;
+    }
+    _position = position;
+
+    for (int i = _capacity; i < capacity; i++) {
+        _position[i] = -1;
+    }
+    _capacity = capacity;
+    return true;
+}
+
+bool InventronixPulseHeap::copyFrom(const InventronixPulseHeap& other) {
+    if (other._capacity > _capacity) {
+        return false;
+    }
+    memcpy(_entries, other._entries, other._count * sizeof(Entry));
+    memcpy(_position, other._position, other._capacity * sizeof(int));
+    for (int i = other._capacity; i < _capacity; i++) {
+        _position[i] = -1;
+    }
+    _count = other._count;
+    return true;
+}
+
+void InventronixPulseHeap::swap(InventronixPulseHeap& other) {
+    Entry* entries = _entries;
+    int* position = _position;
+    int count = _count;
+    int capacity = _capacity;
+
+    _entries = other._entries;
+    _position = other._position;
+    _count = other._count;
+    _capacity = other._capacity;
+
+    other._entries = entries;
+    other._position = position;
+    other._count = count;
+    other._capacity = capacity;
+}
+
+void InventronixPulseHeap::schedule(int id, uint32_t deadline) {
+    if (id < 0 || id >= _capacity) {
+        return;
+    }
+
+    int index = _position[id];
+    if (index < 0) {
+        index = _count++;
+        place(index, {deadline, id});
+        siftUp(index);
+        return;
+    }
+
+    // Already scheduled - move it whichever way the new deadline requires
+    bool sooner = earlier(deadline, _entries[index].deadline);
+    _entries[index].deadline = deadline;
+    if (sooner) {
+        siftUp(index);
+    } else {
+        siftDown(index);
+    }
+}
+
+bool InventronixPulseHeap::cancel(int id) {
+    if (!contains(id)) {
+        return false;
+    }
+
+    int index = _position[id];
+    _position[id] = -1;
+    _count--;
+
+    // Fill the hole with the last entry and restore heap order around it
+    if (index < _count) {
+        Entry last = _entries[_count];
+        bool sooner = earlier(last.deadline, _entries[index].deadline);
+        place(index, last);
+        if (sooner) {
+            siftUp(index);
+        } else {
+            siftDown(index);
+        }
+    }
+    return true;
+}
+
+int InventronixPulseHeap::popDue(uint32_t now) {
+    if (_count == 0 || earlier(now, _entries[0].deadline)) {
+        return -1;
+    }
+    int id = _entries[0].id;
+    cancel(id);
+    return id;
+}
+
+void InventronixPulseHeap::place(int index, const Entry& entry) {
+    _entries[index] = entry;
+    _position[entry.id] = index;
+}
+
+void InventronixPulseHeap::siftUp(int index) {
+    Entry entry = _entries[index];
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!earlier(entry.deadline, _entries[parent].deadline)) {
+            break;
+        }
+        place(index, _entries[parent]);
+        index = parent;
+    }
+    place(index, entry);
+}
+
+void InventronixPulseHeap::siftDown(int index) {
+    Entry entry = _entries[index];
+    while (true) {
+        int child = 2 * index + 1;
+        if (child >= _count) {
+            break;
+        }
+        if (child + 1 < _count && earlier(_entries[child + 1].deadline, _entries[child].deadline)) {
+            child++;
+        }
+        if (!earlier(_entries[child].deadline, entry.deadline)) {
+            break;
+        }
+        place(index, _entries[child]);
+        index = child;
+    }
+    place(index, entry);
+}
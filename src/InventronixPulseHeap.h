@@ -0,0 +1,70 @@
+#ifndef INVENTRONIX_PULSE_HEAP_H
+#define INVENTRONIX_PULSE_HEAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Indexed binary min-heap of pulse deadlines.
+//
+// Each pulse id appears at most once, and its position in the heap is
+// tracked so a running pulse can be rescheduled or cancelled in O(log n).
+// The earliest deadline is always at the top, so the one timer that drives
+// every pulse only ever needs to be armed for top(). Storage grows with
+// reserve() (called as pulses are registered), never while scheduling, so
+// schedule/cancel/popDue are safe to call with interrupts masked. To grow a
+// heap another context is using, reserve() a fresh one unlocked, then
+// copyFrom() and swap() under the lock - neither allocates.
+class InventronixPulseHeap {
+public:
+    InventronixPulseHeap();
+    ~InventronixPulseHeap();
+
+    // Make room for ids 0..ids-1. Returns false if out of memory.
+    bool reserve(int ids);
+
+    // Take over the contents of `other`, which must fit. Returns false if not.
+    bool copyFrom(const InventronixPulseHeap& other);
+
+    // Exchange storage and contents with `other`
+    void swap(InventronixPulseHeap& other);
+
+    // Set (or move) the deadline for `id`
+    void schedule(int id, uint32_t deadline);
+
+    // Remove `id` if it is scheduled. Returns true if it was.
+    bool cancel(int id);
+
+    bool contains(int id) const { return id >= 0 && id < _capacity && _position[id] >= 0; }
+    uint32_t deadlineOf(int id) const { return contains(id) ? _entries[_position[id]].deadline : 0; }
+    bool empty() const { return _count == 0; }
+    int count() const { return _count; }
+
+    // Id and deadline with the earliest deadline (top() is -1 if empty)
+    int top() const { return _count > 0 ? _entries[0].id : -1; }
+    uint32_t topDeadline() const { return _count > 0 ? _entries[0].deadline : 0; }
+
+    // Remove and return the earliest id if its deadline has been reached, else -1.
+    // Deadlines compare with wrap-around, so they must be within 2^31 of `now`.
+    int popDue(uint32_t now);
+
+private:
+    struct Entry {
+        uint32_t deadline;
+        int id;
+    };
+
+    Entry* _entries;
+    int* _position;     // id -> index in _entries (-1 = not scheduled)
+    int _count;
+    int _capacity;
+
+    static bool earlier(uint32_t a, uint32_t b) { return (int32_t)(a - b) < 0; }
+    void place(int index, const Entry& entry);
+    void siftUp(int index);
+    void siftDown(int index);
+
+    InventronixPulseHeap(const InventronixPulseHeap&) = delete;
+    InventronixPulseHeap& operator=(const InventronixPulseHeap&) = delete;
+};
+
+#endif
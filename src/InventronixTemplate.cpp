@@ -0,0 +1,157 @@
+#include "InventronixTemplate.h"
+#include "InventronixFormat.h"
+#include <math.h>
+#include <string.h>
+
+InventronixTemplate::InventronixTemplate()
+    : _length(2), _fieldCount(0), _overflowed(false) {
+    memcpy(_buffer, "{}", 3);
+}
+
+int InventronixTemplate::addFloat(const char* key, uint8_t decimals, uint8_t width) {
+    return addField(key, width, 0, decimals, false);
+}
+
+int InventronixTemplate::addInt(const char* key, uint8_t width) {
+    return addField(key, width, 0, 0, true);
+}
+
+int InventronixTemplate::addBool(const char* key) {
+    return addField(key, 5, 0, 0, true);  // "false" is the widest value
+}
+
+int InventronixTemplate::addFixed(const char* key, uint8_t scale, uint8_t decimals, uint8_t width) {
+    return addField(key, width, scale, decimals, true);
+}
+
+// Replace the closing brace with `,"key":<slot>}` - keys are written once,
+// so they are expected to be plain identifiers (no escaping)
+int InventronixTemplate::addField(const char* key, uint8_t width, uint8_t scale,
+                                  uint8_t decimals, bool fixed) {
+    if (width < 4) {
+        width = 4;  // Always room for "null"
+    }
+
+    size_t keyLength = strlen(key);
+    size_t needed = (_fieldCount > 0 ? 1 : 0) + keyLength + 3 + width + 1;
+    if (_fieldCount >= INVENTRONIX_TEMPLATE_MAX_FIELDS || _length - 1 + needed + 1 > sizeof(_buffer)) {
+        _overflowed = true;
+        return -1;
+    }
+
+    size_t pos = _length - 1;  // Overwrite the closing brace
+    if (_fieldCount > 0) {
+        _buffer[pos++] = ',';
+    }
+    _buffer[pos++] = '"';
+    memcpy(_buffer + pos, key, keyLength);
+    pos += keyLength;
+    _buffer[pos++] = '"';
+    _buffer[pos++] = ':';
+
+    int field = _fieldCount++;
+    _slots[field].offset = (uint16_t)pos;
+    _slots[field].width = width;
+    _slots[field].scale = scale;
+    _slots[field].decimals = decimals;
+    _slots[field].fixed = fixed;
+    pos += width;
+
+    _buffer[pos++] = '}';
+    _buffer[pos] = '\0';
+    _length = pos;
+
+    setNull(field);
+    return field;
+}
+
+bool InventronixTemplate::set(int field, float value) {
+    if (field < 0 || field >= _fieldCount) return false;
+
+    const Slot& slot = _slots[field];
+    if (slot.fixed) {
+        if (isnan(value) || isinf(value)) {
+            return write(field, "null", 4);
+        }
+        return set(field, (long)InventronixFormat::toFixed(value, slot.scale));
+    }
+
+    char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    size_t n = InventronixFormat::formatFloat(digits, value, slot.decimals);
+    return write(field, digits, n);
+}
+
+bool InventronixTemplate::set(int field, double value) {
+    return set(field, (float)value);
+}
+
+bool InventronixTemplate::set(int field, int value) {
+    return set(field, (long)value);
+}
+
+bool InventronixTemplate::set(int field, long value) {
+    if (field < 0 || field >= _fieldCount) return false;
+
+    const Slot& slot = _slots[field];
+    char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    size_t n;
+    if (value >= INT32_MIN && value <= INT32_MAX) {
+        // Float fields show whole numbers with their usual decimals
+        uint8_t scale = slot.fixed ? slot.scale : 0;
+        n = InventronixFormat::formatFixed(digits, (int32_t)value, scale, slot.decimals);
+    } else if (slot.fixed && slot.scale > 0) {
+        // Too large to format with its implied decimals
+        setNull(field);
+        return false;
+    } else {
+        n = InventronixFormat::formatInt64(digits, (int64_t)value);
+    }
+    return write(field, digits, n);
+}
+
+bool InventronixTemplate::set(int field, unsigned int value) {
+    return set(field, (unsigned long)value);
+}
+
+bool InventronixTemplate::set(int field, unsigned long value) {
+    if (field < 0 || field >= _fieldCount) return false;
+
+    // Anything that fits a long takes the fixed-point path
+    if (value <= (unsigned long)INT32_MAX) {
+        return set(field, (long)value);
+    }
+
+    const Slot& slot = _slots[field];
+    if (slot.fixed && slot.scale > 0) {
+        setNull(field);
+        return false;
+    }
+    char digits[INVENTRONIX_NUMBER_BUFFER_SIZE];
+    size_t n = InventronixFormat::formatUInt64(digits, (uint64_t)value);
+    return write(field, digits, n);
+}
+
+bool InventronixTemplate::set(int field, bool value) {
+    return value ? write(field, "true", 4) : write(field, "false", 5);
+}
+
+void InventronixTemplate::setNull(int field) {
+    write(field, "null", 4);
+}
+
+// Right-align `text` in the slot, padding with spaces
+bool InventronixTemplate::write(int field, const char* text, size_t length) {
+    if (field < 0 || field >= _fieldCount) return false;
+
+    const Slot& slot = _slots[field];
+    char* dest = _buffer + slot.offset;
+    if (length > slot.width) {
+        memset(dest, ' ', slot.width - 4);
+        memcpy(dest + slot.width - 4, "null", 4);
+        return false;
+    }
+
+    memset(dest, ' ', slot.width - length);
+    memcpy(dest + slot.width - length, text, length);
+    return true;
+}
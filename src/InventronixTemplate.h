@@ -0,0 +1,78 @@
+#ifndef INVENTRONIX_TEMPLATE_H
+#define INVENTRONIX_TEMPLATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "InventronixConfig.h"
+
+// A payload whose keys never change. The JSON layout is written once, with a
+// fixed-width slot per value; each cycle only the values are patched in place
+// (right-aligned, padded with spaces - still valid JSON), so sending costs a
+// few number formats and one write, with no serialisation.
+//
+//   Inventronix::PayloadTemplate tpl;
+//   int temp = tpl.addFloat("temperature", 1);
+//   int heater = tpl.addBool("heater_on");
+//   ...
+//   tpl.set(temp, readTemp());
+//   tpl.set(heater, heaterOn);
+//   inventronix.sendPayload(tpl);
+class InventronixTemplate {
+public:
+    InventronixTemplate();
+
+    // Declare fields - returns the field handle, or -1 if the template is full.
+    // Every slot starts as null until set() is called.
+    int addFloat(const char* key, uint8_t decimals = INVENTRONIX_PAYLOAD_FLOAT_DECIMALS,
+                 uint8_t width = INVENTRONIX_TEMPLATE_NUMBER_WIDTH);
+    int addInt(const char* key, uint8_t width = INVENTRONIX_TEMPLATE_NUMBER_WIDTH);
+    int addBool(const char* key);
+
+    // Fixed-point field: integers passed to set() are raw values scaled by
+    // 10^scale and are formatted with integer math only; floats are scaled
+    // once and take the same path.
+    int addFixed(const char* key, uint8_t scale, uint8_t decimals,
+                 uint8_t width = INVENTRONIX_TEMPLATE_NUMBER_WIDTH);
+
+    // Patch a value in place. Returns false (and writes null) if the
+    // formatted value is wider than the slot. Integers written to a float
+    // field are whole numbers; to a fixed field they are raw scaled values
+    // (outside the 32-bit range a scaled field is set to null).
+    bool set(int field, float value);
+    bool set(int field, double value);
+    bool set(int field, int value);
+    bool set(int field, long value);
+    bool set(int field, unsigned int value);
+    bool set(int field, unsigned long value);
+    bool set(int field, bool value);
+
+    // Reset a slot to null
+    void setNull(int field);
+
+    // True if a field could not be declared (buffer or field table full)
+    bool overflowed() const { return _overflowed; }
+
+    const char* c_str() const { return _buffer; }
+    size_t length() const { return _length; }
+    int fieldCount() const { return _fieldCount; }
+
+private:
+    struct Slot {
+        uint16_t offset;    // Start of the value in _buffer
+        uint8_t width;
+        uint8_t scale;      // Implied decimals of raw integers (fixed fields)
+        uint8_t decimals;
+        bool fixed;
+    };
+
+    char _buffer[INVENTRONIX_TEMPLATE_SIZE];
+    Slot _slots[INVENTRONIX_TEMPLATE_MAX_FIELDS];
+    size_t _length;
+    int _fieldCount;
+    bool _overflowed;
+
+    int addField(const char* key, uint8_t width, uint8_t scale, uint8_t decimals, bool fixed);
+    bool write(int field, const char* text, size_t length);
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "InventronixTimerWheel.h"
+
+InventronixTimerWheel::InventronixTimerWheel()
+    : _count(0), _currentTick(0), _lastMs(0), _remainderMs(0) {
+    for (int i = 0; i < SLOTS; i++) {
+        _buckets[i] = -1;
+    }
+    for (int i = 0; i < MAP_SIZE; i++) {
+        _map[i] = -1;
+    }
+
+    // Chain every timer onto the free list through `next`
+    for (int i = 0; i < CAPACITY; i++) {
+        _timers[i].active = false;
+        _timers[i].next = (int16_t)(i + 1 < CAPACITY ? i + 1 : -1);
+    }
+    _freeList = 0;
+}
+
+int InventronixTimerWheel::schedule(uint32_t key, uint32_t delayMs, uint32_t nowMs) {
+    if (_freeList < 0) {
+        return -1;
+    }
+    if (_count == 0) {
+        // Nothing pending - restart the time base here
+        _lastMs = nowMs;
+        _remainderMs = 0;
+    }
+
+    int index = _freeList;
+    Timer& timer = _timers[index];
+    _freeList = timer.next;
+
+    // Deadline relative to the tick count, rounded up so a timer never fires early
+    uint64_t offsetMs = (uint64_t)_remainderMs + (uint32_t)(nowMs - _lastMs) + delayMs;
+    timer.key = key;
+    timer.deadlineTick = _currentTick + (uint32_t)((offsetMs + TICK_MS - 1) / TICK_MS);
+    timer.active = true;
+
+    // Push onto the front of its bucket
+    int16_t& head = _buckets[timer.deadlineTick & (SLOTS - 1)];
+    timer.prev = -1;
+    timer.next = head;
+    if (head >= 0) {
+        _timers[head].prev = (int16_t)index;
+    }
+    head = (int16_t)index;
+
+    mapInsert(index);
+    _count++;
+    return index;
+}
+
+void InventronixTimerWheel::cancel(int index) {
+    if (!pending(index)) return;
+
+    Timer& timer = _timers[index];
+    if (timer.prev >= 0) {
+        _timers[timer.prev].next = timer.next;
+    } else {
+        _buckets[timer.deadlineTick & (SLOTS - 1)] = timer.next;
+    }
+    if (timer.next >= 0) {
+        _timers[timer.next].prev = timer.prev;
+    }
+
+    mapRemove(index);
+    timer.active = false;
+    timer.next = _freeList;
+    _freeList = (int16_t)index;
+    _count--;
+}
+
+uint32_t InventronixTimerWheel::remainingMs(int index, uint32_t nowMs) const {
+    if (!pending(index)) return 0;
+    int64_t remaining = (int64_t)(int32_t)(_timers[index].deadlineTick - _currentTick) * TICK_MS -
+                        _remainderMs - (uint32_t)(nowMs - _lastMs);
+    if (remaining <= 0) return 0;
+    return remaining > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)remaining;
+}
+
+uint32_t InventronixTimerWheel::nextDueMs(uint32_t nowMs) const {
+    uint32_t earliest = UINT32_MAX;
+    if (_count == 0) return earliest;
+    for (int i = 0; i < CAPACITY; i++) {
+        uint32_t remaining = remainingMs(i, nowMs);
+        if (_timers[i].active && remaining < earliest) {
+            earliest = remaining;
+        }
+    }
+    return earliest;
+}
+
+void InventronixTimerWheel::mapInsert(int index) {
+    int i = _timers[index].key & (MAP_SIZE - 1);
+    while (_map[i] >= 0) {
+        i = (i + 1) & (MAP_SIZE - 1);
+    }
+    _map[i] = (int16_t)index;
+}
+
+// Linear-probing delete with backward shift, so no tombstones build up
+void InventronixTimerWheel::mapRemove(int index) {
+    int i = _timers[index].key & (MAP_SIZE - 1);
+    while (_map[i] != index) {
+        if (_map[i] < 0) return;
+        i = (i + 1) & (MAP_SIZE - 1);
+    }
+
+    _map[i] = -1;
+    int j = i;
+    for (;;) {
+        j = (j + 1) & (MAP_SIZE - 1);
+        if (_map[j] < 0) break;
+
+        // Move the entry back if its home slot is not in (i, j]
+        int home = _timers[_map[j]].key & (MAP_SIZE - 1);
+        bool between = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+        if (!between) {
+            _map[i] = _map[j];
+            _map[j] = -1;
+            i = j;
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef INVENTRONIX_TIMER_WHEEL_H
+#define INVENTRONIX_TIMER_WHEEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "InventronixConfig.h"
+
+// Hashed timing wheel over a fixed pool of timers.
+//
+// Each timer lives in the bucket for its deadline tick (deadline % SLOTS) on
+// an intrusive doubly-linked list, and is also indexed by a caller-supplied
+// 32-bit key, so scheduling, lookup and cancellation are all O(1).
+// advance() visits one bucket per elapsed tick and fires the timers whose
+// deadline has been reached; timers more than one revolution out simply stay
+// in their bucket until their tick comes round.
+//
+// The tick count is the wheel's own: it advances by the milliseconds that
+// have passed between calls (the remainder carried over), never by dividing
+// millis(), so it stays monotonic across the 49.7-day millis() rollover.
+class InventronixTimerWheel {
+public:
+    static const int CAPACITY = INVENTRONIX_MAX_SCHEDULED_COMMANDS;
+    static const int SLOTS = INVENTRONIX_TIMER_WHEEL_SLOTS;   // Power of two
+    static const uint32_t TICK_MS = INVENTRONIX_TIMER_WHEEL_TICK_MS;
+
+    InventronixTimerWheel();
+
+    // Start a timer `delayMs` from `nowMs`. Returns its pool index, or -1 if full.
+    int schedule(uint32_t key, uint32_t delayMs, uint32_t nowMs);
+
+    // Pool index of a pending timer with this key for which match(index) is
+    // true (the key is a hash, so callers confirm), or -1
+    template <typename Match>
+    int find(uint32_t key, Match match) const {
+        for (int i = key & (MAP_SIZE - 1); _map[i] >= 0; i = (i + 1) & (MAP_SIZE - 1)) {
+            if (_timers[_map[i]].key == key && match(_map[i])) {
+                return _map[i];
+            }
+        }
+        return -1;
+    }
+
+    // Remove a pending timer by pool index
+    void cancel(int index);
+
+    // Fire every timer due by `nowMs`: fire(index) is called after the timer
+    // is unlinked, so the callback may schedule new timers
+    template <typename Fire>
+    void advance(uint32_t nowMs, Fire fire) {
+        if (_count == 0) {
+            _lastMs = nowMs;
+            _remainderMs = 0;
+            return;
+        }
+
+        // Whole ticks since the last call; the leftover carries to the next
+        uint32_t elapsedMs = nowMs - _lastMs;
+        uint32_t ticks = elapsedMs / TICK_MS;
+        uint32_t remainderMs = _remainderMs + elapsedMs % TICK_MS;
+        if (remainderMs >= TICK_MS) {
+            remainderMs -= TICK_MS;
+            ticks++;
+        }
+        _lastMs = nowMs;
+        _remainderMs = remainderMs;
+        uint32_t target = _currentTick + ticks;
+
+        // Visit each elapsed bucket once (at most one full revolution)
+        uint32_t elapsed = target - _currentTick;
+        uint32_t steps = (elapsed >= (uint32_t)SLOTS) ? SLOTS : elapsed + 1;
+        uint32_t tick = target - (steps - 1);
+        for (uint32_t n = 0; n < steps; n++, tick++) {
+            int16_t& head = _buckets[tick & (SLOTS - 1)];
+            int i = head;
+            while (i >= 0) {
+                if ((int32_t)(_timers[i].deadlineTick - target) <= 0) {
+                    cancel(i);
+                    fire(i);
+                    i = head;   // The callback may have changed this bucket
+                } else {
+                    i = _timers[i].next;
+                }
+            }
+        }
+        _currentTick = target;
+    }
+
+    bool pending(int index) const { return index >= 0 && index < CAPACITY && _timers[index].active; }
+    int count() const { return _count; }
+
+    // Milliseconds until timer `index` is due (0 if overdue)
+    uint32_t remainingMs(int index, uint32_t nowMs) const;
+
+    // Milliseconds until the earliest pending timer is due (0 if overdue,
+    // UINT32_MAX if none)
+    uint32_t nextDueMs(uint32_t nowMs) const;
+
+private:
+    static const int MAP_SIZE = 2 * CAPACITY;   // Load factor <= 1/2
+
+    struct Timer {
+        uint32_t key;
+        uint32_t deadlineTick;
+        int16_t prev;
+        int16_t next;
+        bool active;
+    };
+
+    Timer _timers[CAPACITY];
+    int16_t _buckets[SLOTS];        // Head of each bucket's list (-1 = empty)
+    int16_t _map[MAP_SIZE];         // key -> timer index (-1 = empty)
+    int16_t _freeList;
+    int _count;
+    uint32_t _currentTick;          // Ticks counted so far (wraps after 2^32 ticks)
+    uint32_t _lastMs;               // millis() that _currentTick was last brought up to
+    uint32_t _remainderMs;          // Milliseconds past _currentTick at _lastMs (< TICK_MS)
+
+    void mapInsert(int index);
+    void mapRemove(int index);
+};
+
+#endif
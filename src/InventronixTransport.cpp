@@ -0,0 +1,245 @@
+#include <Arduino.h>
+#include <new>
+#include "Inventronix.h"
+
+#ifdef INVENTRONIX_PLATFORM_ESP
+
+// ============================================
+// ESP32 / ESP8266: HTTPClient over WiFiClientSecure
+// ============================================
+
+InventronixPlatformTransport::InventronixPlatformTransport()
+    : _host(nullptr), _port(0), _secure(true), _bodyLeft(-1), _status(0), _headerIndex(0),
+      _bodyOffset(0), _bodyBuffered(false) {
+}
+
+InventronixPlatformTransport::~InventronixPlatformTransport() {
+    close();
+}
+
+// Connect up front so a failed connect is reported separately from the
+// request. The built-in client always uses TLS.
+int InventronixPlatformTransport::open(const char* host, uint16_t port, bool secure) {
+    _host = host;
+    _port = port;
+    _secure = secure;
+    _status = 0;
+    _headerIndex = 0;
+    _bodyLeft = -1;
+    _bodyOffset = 0;
+    _bodyBuffered = false;
+
+    // Skip SSL certificate verification (for simplicity)
+    _client.setInsecure();
+    if (!_client.connect(host, port, INVENTRONIX_HTTP_TIMEOUT)) {
+        return INVENTRONIX_TRANSPORT_CONNECT_FAILED;
+    }
+    return 0;
+}
+
+// HTTPClient sends the request and reads the status line and headers in one
+// call; the status is held for readStatus()
+int InventronixPlatformTransport::writeRequest(const InventronixRequest& request) {
+    // Reuses the connection made by open()
+    _http.begin(_client, _host, _port, request.path, _secure);
+    _http.setTimeout(INVENTRONIX_HTTP_TIMEOUT);
+
+    for (uint8_t i = 0; i < request.headerCount; i++) {
+        _http.addHeader(request.headers[i].name, request.headers[i].value);
+    }
+
+    // Keep the Date header for scheduled commands
+    const char* collectHeaders[] = {"Date"};
+    _http.collectHeaders(collectHeaders, 1);
+
+    // Raw bytes - avoids copying the body into a String
+    _status = _http.sendRequest(request.method, (uint8_t*)request.body, request.bodyLength);
+    if (_status <= 0) {
+        return _status < 0 ? _status : INVENTRONIX_TRANSPORT_READ_FAILED;
+    }
+    _bodyLeft = _http.getSize();
+    return 0;
+}
+
+int InventronixPlatformTransport::readStatus() {
+    return _status;
+}
+
+// Only collected headers are available; absent ones come back empty
+bool InventronixPlatformTransport::readHeader(String& name, String& value) {
+    while (_headerIndex < _http.headers()) {
+        int i = _headerIndex++;
+        value = _http.header(i);
+        if (value.length() > 0) {
+            name = _http.headerName(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+int InventronixPlatformTransport::readBody(uint8_t* buffer, size_t size) {
+    // Known length: straight off the connection
+    if (_bodyLeft >= 0) {
+        if (_bodyLeft == 0) {
+            return 0;
+        }
+        if ((long)size > _bodyLeft) {
+            size = (size_t)_bodyLeft;
+        }
+        Stream* stream = _http.getStreamPtr();
+        int length = stream ? (int)stream->readBytes(buffer, size) : 0;
+        if (length <= 0) {
+            return INVENTRONIX_TRANSPORT_READ_FAILED;
+        }
+        _bodyLeft -= length;
+        return length;
+    }
+
+    // Chunked or close-delimited: HTTPClient de-chunks it in one go
+    if (!_bodyBuffered) {
+        _body = _http.getString();
+        _bodyBuffered = true;
+    }
+    size_t left = _body.length() - _bodyOffset;
+    if (size > left) {
+        size = left;
+    }
+    memcpy(buffer, _body.c_str() + _bodyOffset, size);
+    _bodyOffset += size;
+    return (int)size;
+}
+
+void InventronixPlatformTransport::close() {
+    _http.end();
+    _client.stop();
+    _body = String();
+}
+
+#else
+
+// ============================================
+// UNO R4 WiFi / Renesas: ArduinoHttpClient over WiFiSSLClient
+// ============================================
+
+InventronixPlatformTransport::InventronixPlatformTransport()
+    : _host(nullptr), _port(0), _secure(true), _bodyLeft(-1), _http(nullptr), _bodyStarted(false) {
+}
+
+InventronixPlatformTransport::~InventronixPlatformTransport() {
+    close();
+}
+
+// The built-in client always uses TLS
+int InventronixPlatformTransport::open(const char* host, uint16_t port, bool secure) {
+    close();    // In case the previous request was never closed
+    _host = host;
+    _port = port;
+    _secure = secure;
+    _bodyLeft = -1;
+    _bodyStarted = false;
+
+    // Drain any residual data and reset the client properly
+    while (_client.available()) {
+        _client.read();
+    }
+    if (_client.connected()) {
+        _client.stop();
+    }
+
+    // Explicitly connect first (R4 WiFiSSLClient quirk - helps with some servers)
+    if (!_client.connect(host, port)) {
+        return INVENTRONIX_TRANSPORT_CONNECT_FAILED;
+    }
+
+    _http = new (_httpStorage) HttpClient(_client, host, port);
+    _http->setTimeout(INVENTRONIX_HTTP_TIMEOUT);
+    return 0;
+}
+
+int InventronixPlatformTransport::writeRequest(const InventronixRequest& request) {
+    if (!_http) {
+        return INVENTRONIX_TRANSPORT_WRITE_FAILED;
+    }
+
+    _http->beginRequest();
+    if (_http->startRequest(request.path, request.method) < 0) {
+        return INVENTRONIX_TRANSPORT_WRITE_FAILED;
+    }
+    for (uint8_t i = 0; i < request.headerCount; i++) {
+        _http->sendHeader(request.headers[i].name, request.headers[i].value);
+    }
+    _http->sendHeader("Content-Length", (int)request.bodyLength);
+    _http->beginBody();
+    size_t written = _http->write((const uint8_t*)request.body, request.bodyLength);
+    _http->endRequest();
+    return written == request.bodyLength ? 0 : INVENTRONIX_TRANSPORT_WRITE_FAILED;
+}
+
+int InventronixPlatformTransport::readStatus() {
+    return _http ? _http->responseStatusCode() : INVENTRONIX_TRANSPORT_READ_FAILED;
+}
+
+bool InventronixPlatformTransport::readHeader(String& name, String& value) {
+    if (!_http || !_http->headerAvailable()) {
+        return false;
+    }
+    name = _http->readHeaderName();
+    value = _http->readHeaderValue();
+    return true;
+}
+
+int InventronixPlatformTransport::readBody(uint8_t* buffer, size_t size) {
+    if (!_http) {
+        return INVENTRONIX_TRANSPORT_READ_FAILED;
+    }
+    if (!_bodyStarted) {
+        _bodyLeft = _http->contentLength();     // Skips any unread headers
+        _bodyStarted = true;
+    }
+    if (_bodyLeft == 0) {
+        return 0;
+    }
+
+    // Known length: block reads straight off the connection
+    unsigned long start = millis();
+    if (_bodyLeft > 0) {
+        if ((long)size > _bodyLeft) {
+            size = (size_t)_bodyLeft;
+        }
+        int length;
+        while ((length = _http->read(buffer, size)) <= 0) {
+            if (!_http->connected() || millis() - start >= INVENTRONIX_HTTP_TIMEOUT) {
+                return INVENTRONIX_TRANSPORT_READ_FAILED;
+            }
+            delay(1);
+        }
+        _bodyLeft -= length;
+        return length;
+    }
+
+    // Unknown length: a byte at a time, so HttpClient can de-chunk
+    size_t count = 0;
+    while (count < size) {
+        int c = _http->read();
+        if (c >= 0) {
+            buffer[count++] = (uint8_t)c;
+            continue;
+        }
+        if (count > 0 || !_http->connected() || millis() - start >= INVENTRONIX_HTTP_TIMEOUT) {
+            break;
+        }
+        delay(1);
+    }
+    return (int)count;
+}
+
+void InventronixPlatformTransport::close() {
+    if (_http) {
+        _http->stop();
+        _http->~HttpClient();
+        _http = nullptr;
+    }
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef INVENTRONIX_TRANSPORT_H
+#define INVENTRONIX_TRANSPORT_H
+
+#include <Arduino.h>
+
+// Transport error codes (negative, so they cannot be mistaken for a status)
+#define INVENTRONIX_TRANSPORT_CONNECT_FAILED -1
+#define INVENTRONIX_TRANSPORT_WRITE_FAILED -2
+#define INVENTRONIX_TRANSPORT_READ_FAILED -3
+
+// One request header
+struct InventronixHeader {
+    const char* name;
+    const char* value;
+};
+
+// One HTTP request as the library hands it to a transport. The transport
+// adds Host and Content-Length itself.
+struct InventronixRequest {
+    const char* method;
+    const char* host;
+    const char* path;                   // Including any query string
+    const InventronixHeader* headers;
+    uint8_t headerCount;
+    const char* body;
+    size_t bodyLength;
+};
+
+// How a request reaches the server. Inventronix drives one request at a time:
+//
+//   open() -> writeRequest() -> readStatus() -> readHeader()... -> readBody()... -> close()
+//
+// close() is called after every open(), whether or not the request got
+// through. The built-in transport (HTTPClient on ESP32, ArduinoHttpClient on
+// UNO R4) is used unless another is set with Inventronix::setTransport().
+class InventronixTransport {
+public:
+    virtual ~InventronixTransport() {}
+
+    // Connect to host:port, over TLS if `secure`. `host` stays valid until
+    // close(). Returns 0 or a negative error code.
+    virtual int open(const char* host, uint16_t port, bool secure) = 0;
+
+    // Send the request line, headers and body. Returns 0 or a negative error code.
+    virtual int writeRequest(const InventronixRequest& request) = 0;
+
+    // HTTP status code of the response, or a negative error code
+    virtual int readStatus() = 0;
+
+    // Next response header. Returns false once the headers are done; a
+    // transport may report only the headers the library uses (Date).
+    virtual bool readHeader(String& name, String& value) = 0;
+
+    // Up to `size` bytes of the (de-chunked) response body. Returns the
+    // number read, 0 at the end of the body, or a negative error code.
+    // Unread headers are skipped.
+    virtual int readBody(uint8_t* buffer, size_t size) = 0;
+
+    // Finish the request and release the connection
+    virtual void close() = 0;
+};
+
+#endif